@@ -0,0 +1,247 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+// Saida assincrona para traces dos cenarios.
+//
+// As fontes de trace (na thread do simulador) empurram registros de tamanho
+// fixo numa fila circular lock-free de um produtor e um consumidor; uma
+// thread dedicada formata e grava em blocos grandes. Se a fila enche, o
+// produtor espera (nada e descartado) e o evento conta como backpressure.
+// Stop() esvazia a fila e fecha os arquivos; os scripts o registram com
+// Simulator::ScheduleDestroy para garantir o flush no Simulator::Destroy().
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace asyncwriter
+{
+
+constexpr std::size_t kMaxValues = 3;
+
+// Uma linha: "<time> <v0> [<v1> [<v2>]]". O tempo sai como o ostream padrao
+// o escreveria (%g), ou como timeText se dado (literal estatico, ex. "0.0").
+struct Record
+{
+    uint32_t stream;
+    uint32_t nValues;
+    double time;
+    int64_t values[kMaxValues];
+    const char* timeText;
+};
+
+struct Stats
+{
+    uint64_t records = 0;     // registros aceitos
+    uint64_t fullStalls = 0;  // vezes em que o produtor achou a fila cheia
+    uint64_t maxDepth = 0;    // maior ocupacao observada pelo produtor
+    uint64_t writes = 0;      // chamadas fwrite feitas pela thread
+};
+
+class AsyncWriter
+{
+  public:
+    explicit AsyncWriter(std::size_t capacity = 1 << 16, std::size_t flushBytes = 1 << 20)
+        : m_ring(RoundUp(capacity)),
+          m_mask(m_ring.size() - 1),
+          m_flushBytes(flushBytes)
+    {
+    }
+
+    ~AsyncWriter()
+    {
+        Stop();
+    }
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    // Abre um arquivo de saida e devolve o id usado em Push().
+    uint32_t Open(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        auto out = std::make_unique<Output>();
+        out->file = std::fopen(path.c_str(), "w");
+        if (!out->file)
+            throw std::runtime_error("asyncwriter: cannot open " + path);
+        m_streams.push_back(std::move(out));
+        if (!m_thread.joinable() && !m_stopped)
+            m_thread = std::thread(&AsyncWriter::Run, this);
+        return m_streams.size() - 1;
+    }
+
+    void Push(uint32_t stream, double time, int64_t v0)
+    {
+        Push({stream, 1, time, {v0, 0, 0}, nullptr});
+    }
+
+    void Push(uint32_t stream, const char* timeText, int64_t v0)
+    {
+        Push({stream, 1, 0.0, {v0, 0, 0}, timeText});
+    }
+
+    void Push(uint32_t stream, double time, int64_t v0, int64_t v1)
+    {
+        Push({stream, 2, time, {v0, v1, 0}, nullptr});
+    }
+
+    void Push(const Record& r)
+    {
+        if (m_stopped)
+            return;
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        std::size_t depth = head - m_tail.load(std::memory_order_acquire);
+        if (depth >= m_ring.size())
+        {
+            ++m_stats.fullStalls;
+            while (head - m_tail.load(std::memory_order_acquire) >= m_ring.size())
+                std::this_thread::yield();
+            depth = head - m_tail.load(std::memory_order_acquire);
+        }
+        if (depth + 1 > m_stats.maxDepth)
+            m_stats.maxDepth = depth + 1;
+        m_ring[head & m_mask] = r;
+        m_head.store(head + 1, std::memory_order_release);
+        ++m_stats.records;
+    }
+
+    // Esvazia a fila, grava o que falta e fecha os arquivos. Idempotente.
+    void Stop()
+    {
+        if (m_stopped)
+            return;
+        m_stopped = true;
+        m_stop.store(true, std::memory_order_release);
+        if (m_thread.joinable())
+            m_thread.join();
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        for (auto& out : m_streams)
+        {
+            FlushOutput(*out);
+            if (out->file)
+                std::fclose(out->file);
+            out->file = nullptr;
+        }
+    }
+
+    // Valores finais so depois de Stop().
+    Stats GetStats() const
+    {
+        Stats s = m_stats;
+        s.writes = m_writes.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // Linha de backpressure que os scripts imprimem depois do Stop().
+    void PrintStats(std::ostream& os) const
+    {
+        Stats s = GetStats();
+        os << "Trace records=" << s.records
+           << " queueFullStalls=" << s.fullStalls
+           << " maxQueueDepth=" << s.maxDepth
+           << " writes=" << s.writes << std::endl;
+    }
+
+  private:
+    struct Output
+    {
+        std::FILE* file = nullptr;
+        std::string buffer;
+    };
+
+    static std::size_t RoundUp(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    void Run()
+    {
+        while (true)
+        {
+            bool stopping = m_stop.load(std::memory_order_acquire);
+            if (Drain() == 0)
+            {
+                if (stopping)
+                    break;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    std::size_t Drain()
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        if (head == tail)
+            return 0;
+
+        // So a copia dos ponteiros e feita sob o lock: formatar e gravar fora
+        // dele, para um Open() na thread do simulador nunca esperar por disco.
+        // Os Output nao mudam de endereco quando m_streams cresce.
+        {
+            std::lock_guard<std::mutex> lock(m_streamsMutex);
+            for (std::size_t s = m_outputs.size(); s < m_streams.size(); ++s)
+                m_outputs.push_back(m_streams[s].get());
+        }
+        char line[128];
+        for (std::size_t i = tail; i != head; ++i)
+        {
+            const Record& r = m_ring[i & m_mask];
+            int n = r.timeText ? std::snprintf(line, sizeof(line), "%s", r.timeText)
+                               : std::snprintf(line, sizeof(line), "%g", r.time);
+            for (uint32_t v = 0; v < r.nValues && v < kMaxValues; ++v)
+                n += std::snprintf(line + n, sizeof(line) - n, " %" PRId64, r.values[v]);
+            line[n++] = '\n';
+            Output& out = *m_outputs[r.stream];
+            out.buffer.append(line, n);
+            if (out.buffer.size() >= m_flushBytes)
+                FlushOutput(out);
+        }
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    void FlushOutput(Output& out)
+    {
+        if (out.file && !out.buffer.empty())
+        {
+            std::fwrite(out.buffer.data(), 1, out.buffer.size(), out.file);
+            m_writes.fetch_add(1, std::memory_order_relaxed);
+        }
+        out.buffer.clear();
+    }
+
+    std::vector<Record> m_ring;
+    std::size_t m_mask;
+    std::size_t m_flushBytes;
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_writes{0};
+    bool m_stopped = false;
+    Stats m_stats;
+    std::mutex m_streamsMutex;
+    std::vector<std::unique_ptr<Output>> m_streams;
+    std::vector<Output*> m_outputs;  // copia de m_streams usada so pela thread
+    std::thread m_thread;
+};
+
+} // namespace asyncwriter
+
+#endif // ASYNC_WRITER_H
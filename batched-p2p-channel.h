@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef BATCHED_P2P_CHANNEL_H
+#define BATCHED_P2P_CHANNEL_H
+
+// Canal ponto-a-ponto em lotes para enlaces que nao sao gargalo.
+//
+// O PointToPointChannel agenda um evento de recepcao por pacote. Aqui o
+// instante de chegada de cada pacote (inicio da transmissao + txTime +
+// atraso) e guardado numa fila por sentido; o evento de chegada de um pacote
+// tambem entrega os pacotes da fila que chegam ate BatchWindow depois dele.
+//
+// O alcance e limitado: so entram no lote pacotes cuja transmissao ja comecou
+// quando o evento dispara. Numa rajada em sequencia isso da no maximo dois
+// pacotes por evento (com a janela padrao de um segmento), e so no sentido da
+// fonte; enlaces alimentados pelo gargalo recebem pacotes ja espacados e nao
+// agrupam. Os eventos de fim de transmissao do device continuam um por
+// pacote. O pacote que abre o evento chega no tempo exato; os que vao junto
+// chegam adiantados ate BatchWindow. Com BatchWindow = 0 o canal usa o
+// caminho do PointToPointChannel, identico ao original.
+//
+// O trace TxRxPointToPoint do canal base e privado e so dispara nesse
+// caminho; com lotes o canal dispara BatchedTxRx, com a mesma assinatura.
+
+#include "ns3/drop-tail-queue.h"
+#include "ns3/mac48-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include <deque>
+
+namespace ns3
+{
+
+class BatchedPointToPointChannel : public PointToPointChannel
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::BatchedPointToPointChannel")
+                .SetParent<PointToPointChannel>()
+                .SetGroupName("PointToPoint")
+                .AddConstructor<BatchedPointToPointChannel>()
+                .AddAttribute("BatchWindow",
+                              "Packets already in flight that arrive within this window after "
+                              "a packet are delivered early by that packet's receive event",
+                              TimeValue(Seconds(0)),
+                              MakeTimeAccessor(&BatchedPointToPointChannel::m_window),
+                              MakeTimeChecker())
+                .AddTraceSource("BatchedTxRx",
+                                "Same as TxRxPointToPoint, fired when the packet is batched",
+                                MakeTraceSourceAccessor(&BatchedPointToPointChannel::m_txrx),
+                                "ns3::PointToPointChannel::TxRxAnimationCallback");
+        return tid;
+    }
+
+    bool TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override
+    {
+        ++m_nPackets;
+        if (m_window.IsZero())
+        {
+            ++m_nEvents;
+            return PointToPointChannel::TransmitStart(p, src, txTime);
+        }
+        NS_ASSERT(IsInitialized());
+        uint32_t wire = GetSource(0) == src ? 0 : 1;
+        Time arrival = Simulator::Now() + txTime + GetDelay();
+        m_pending[wire].push_back({p->Copy(), arrival});
+        m_txrx(p, src, GetDestination(wire), txTime, txTime + GetDelay());
+        if (!m_scheduled[wire])
+            ScheduleTrain(wire);
+        return true;
+    }
+
+    uint64_t GetNPackets() const { return m_nPackets; }
+    uint64_t GetNEvents() const { return m_nEvents; }
+
+  private:
+    struct Pending
+    {
+        Ptr<Packet> packet;
+        Time arrival;
+    };
+
+    void ScheduleTrain(uint32_t wire)
+    {
+        Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+        Simulator::ScheduleWithContext(dst->GetNode()->GetId(),
+                                       m_pending[wire].front().arrival - Simulator::Now(),
+                                       &BatchedPointToPointChannel::DeliverTrain,
+                                       this,
+                                       wire);
+        m_scheduled[wire] = true;
+    }
+
+    void DeliverTrain(uint32_t wire)
+    {
+        ++m_nEvents;
+        m_scheduled[wire] = false;
+        Ptr<PointToPointNetDevice> dst = GetDestination(wire);
+        Time last = Simulator::Now() + m_window;
+        while (!m_pending[wire].empty() && m_pending[wire].front().arrival <= last)
+        {
+            Ptr<Packet> packet = m_pending[wire].front().packet;
+            m_pending[wire].pop_front();
+            dst->Receive(packet);
+        }
+        if (!m_pending[wire].empty())
+            ScheduleTrain(wire);
+    }
+
+    Time m_window;
+    TracedCallback<Ptr<const Packet>, Ptr<NetDevice>, Ptr<NetDevice>, Time, Time> m_txrx;
+    std::deque<Pending> m_pending[2];
+    bool m_scheduled[2] = {false, false};
+    uint64_t m_nPackets = 0;
+    uint64_t m_nEvents = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(BatchedPointToPointChannel);
+
+// Equivalente ao PointToPointHelper::Install(a, b), mas com o canal em lotes.
+inline NetDeviceContainer
+InstallBatchedPointToPoint(Ptr<Node> a,
+                           Ptr<Node> b,
+                           const std::string& dataRate,
+                           const std::string& delay,
+                           Time window)
+{
+    NetDeviceContainer container;
+    Ptr<BatchedPointToPointChannel> channel = CreateObject<BatchedPointToPointChannel>();
+    channel->SetAttribute("Delay", StringValue(delay));
+    channel->SetAttribute("BatchWindow", TimeValue(window));
+    for (Ptr<Node> node : {a, b})
+    {
+        Ptr<PointToPointNetDevice> dev = CreateObject<PointToPointNetDevice>();
+        dev->SetAttribute("DataRate", StringValue(dataRate));
+        dev->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(dev);
+        Ptr<Queue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+        dev->SetQueue(queue);
+        Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface>();
+        ndqi->GetTxQueue(0)->ConnectQueueTraces(queue);
+        dev->AggregateObject(ndqi);
+        dev->Attach(channel);
+        container.Add(dev);
+    }
+    return container;
+}
+
+} // namespace ns3
+
+#endif // BATCHED_P2P_CHANNEL_H
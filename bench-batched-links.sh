@@ -0,0 +1,44 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Antes/depois dos enlaces de acesso em lotes (tcp-variants-comparison-1-b
+# --batchedLinks): goodput agregado, eventos totais do simulador e eventos
+# de recepcao nos enlaces de acesso, com o canal original e com lotes para
+# algumas janelas (vazia = padrao, um segmento no acesso). GoodputDelta e
+# relativo a linha sem lotes do mesmo nFlows; e dele que sai a janela padrao.
+# SrcRxEvents/SrcPackets separam o enlace da fonte, o unico que agrupa: nos
+# enlaces r2->dst os pacotes chegam espacados pelo gargalo, e os eventos de
+# fim de transmissao nao mudam. Espere no maximo ~2 pacotes por evento ali.
+#
+# Rodar a partir da raiz do ns-3, com os cenarios em scratch/ e build
+# otimizado:
+#
+#   sh scratch/bench-batched-links.sh [simStop] ["janelas"]
+
+SIM_STOP=${1:-20}
+WINDOWS=${2:-"10us default 100us"}
+
+echo "nFlows,BatchWindow,Goodput(Mbps),GoodputDelta(%),Events,AccessRxEvents,AccessPackets,SrcRxEvents,SrcPackets,Wall(s)"
+for NFLOWS in 1 10 100; do
+    BASE=""
+    for WINDOW in off $WINDOWS; do
+        case "$WINDOW" in
+            off) OPTS="" ;;
+            default) OPTS="--batchedLinks=true" ;;
+            *) OPTS="--batchedLinks=true --batchWindow=$WINDOW" ;;
+        esac
+        OUT=$(./ns3 run --no-build "tcp-variants-comparison-1-b --nFlows=$NFLOWS --simStop=$SIM_STOP \
+            --simStats=true $OPTS" 2>/dev/null)
+        GOODPUT=$(echo "$OUT" | sed -n 's/.*Goodput_agregado=\([^ ]*\) Mbps.*/\1/p')
+        EVENTS=$(echo "$OUT" | sed -n 's/^SimStats .*events=\([0-9]*\).*/\1/p')
+        WALL=$(echo "$OUT" | sed -n 's/^SimStats wall=\([^ ]*\).*/\1/p')
+        RX=$(echo "$OUT" | sed -n 's/^BatchedLinks .*rxEvents=\([0-9]*\).*/\1/p')
+        PACKETS=$(echo "$OUT" | sed -n 's/^BatchedLinks .* packets=\([0-9]*\).*/\1/p')
+        SRC_RX=$(echo "$OUT" | sed -n 's/^BatchedLinks .*srcRxEvents=\([0-9]*\).*/\1/p')
+        SRC_PACKETS=$(echo "$OUT" | sed -n 's/^BatchedLinks .*srcPackets=\([0-9]*\).*/\1/p')
+        [ "$WINDOW" = default ] && WINDOW=$(echo "$OUT" | sed -n 's/^BatchedLinks window=\([^ ]*\).*/\1/p')
+        [ -z "$BASE" ] && BASE=$GOODPUT
+        DELTA=$(awk -v g="$GOODPUT" -v b="$BASE" 'BEGIN {if (b > 0) printf "%.3f", 100 * (g - b) / b}')
+        echo "$NFLOWS,$WINDOW,$GOODPUT,$DELTA,$EVENTS,$RX,$PACKETS,$SRC_RX,$SRC_PACKETS,$WALL"
+    done
+done
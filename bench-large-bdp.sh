@@ -0,0 +1,31 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Benchmark do modo large-BDP (tcp-variants-comparison-1-b --largeBdp):
+# tempo de parede por segundo simulado e numero de eventos para gargalos de
+# 1, 10 e 40 Gbps com RTT > 100 ms (delay de gargalo de 50 ms, ida e volta).
+# Sem perdas (--errorRate=0): com a taxa por byte dos scripts os quadros
+# jumbo se perdem e o enlace fica quase ocioso. As fontes comecam em 1 s, entao
+# WallPerSimSec e medido sobre o tempo ativo (simStop - 1); o simStop padrao
+# de 10 s deixa a maior parte da execucao fora do slow start.
+#
+# Rodar a partir da raiz do ns-3, com os cenarios em scratch/ e build
+# otimizado (./ns3 configure --build-profile=optimized):
+#
+#   sh scratch/bench-large-bdp.sh [delay] [simStop] [nFlows]
+#
+# Saida: uma linha CSV por taxa, para acompanhar melhorias ao longo do tempo.
+
+DELAY=${1:-50ms}
+SIM_STOP=${2:-10}
+NFLOWS=${3:-1}
+
+echo "DataRate,Delay,nFlows,SimStop(s),Wall(s),WallPerSimSec(s),Events"
+for RATE in 1Gbps 10Gbps 40Gbps; do
+    OUT=$(./ns3 run --no-build "tcp-variants-comparison-1-b --largeBdp=true --errorRate=0 --dataRate=$RATE \
+        --delay=$DELAY --simStop=$SIM_STOP --nFlows=$NFLOWS" 2>/dev/null | grep '^Wall=')
+    WALL=$(echo "$OUT" | sed -n 's/.*Wall=\([^s]*\)s .*/\1/p')
+    PER_SEC=$(echo "$OUT" | sed -n 's/.*WallPerSimSec=\([^s]*\)s.*/\1/p')
+    EVENTS=$(echo "$OUT" | sed -n 's/.*Events=\([0-9]*\).*/\1/p')
+    echo "$RATE,$DELAY,$NFLOWS,$SIM_STOP,$WALL,$PER_SEC,$EVENTS"
+done
@@ -0,0 +1,43 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Benchmark do pool de pacotes: compara o binario normal (alocador padrao)
+# com tcp-variants-comparison-1-b-pool (packet-pool.h compilado), este com o
+# pool desligado e ligado. Reporta tempo de parede, pico de RSS, chamadas ao
+# heap e acertos do pool para um numero alto de fluxos; Wall e RSS saem como
+# delta sobre o binario normal.
+#
+# Rodar a partir da raiz do ns-3, com os cenarios em scratch/ e build
+# otimizado:
+#
+#   sh scratch/bench-packet-pool.sh [nFlows] [simStop]
+
+NFLOWS=${1:-1000}
+SIM_STOP=${2:-5}
+
+./ns3 build tcp-variants-comparison-1-b tcp-variants-comparison-1-b-pool >/dev/null || exit 1
+
+echo "Binary,packetPool,nFlows,SimStop(s),Wall(s),WallDelta(%),PeakRSS(KB),RSSDelta(%),Allocs,PoolHits,HeapCalls"
+BASE_WALL=""
+BASE_RSS=""
+for VARIANT in "tcp-variants-comparison-1-b" "tcp-variants-comparison-1-b-pool false" \
+               "tcp-variants-comparison-1-b-pool true"; do
+    set -- $VARIANT
+    PROG=$1
+    POOL=${2:-}
+    OPTS=""
+    [ -n "$POOL" ] && OPTS="--packetPool=$POOL --allocStats=true"
+    TMP=$(mktemp)
+    /usr/bin/time -f "TIME %e %M" -o "$TMP" ./ns3 run --no-build \
+        "$PROG --nFlows=$NFLOWS --simStop=$SIM_STOP $OPTS" >"$TMP.out" 2>/dev/null
+    WALL=$(awk '/^TIME/ {print $2}' "$TMP")
+    RSS=$(awk '/^TIME/ {print $3}' "$TMP")
+    [ -z "$BASE_WALL" ] && BASE_WALL=$WALL && BASE_RSS=$RSS
+    DWALL=$(awk -v v="$WALL" -v b="$BASE_WALL" 'BEGIN {if (b > 0) printf "%.1f", 100 * (v - b) / b}')
+    DRSS=$(awk -v v="$RSS" -v b="$BASE_RSS" 'BEGIN {if (b > 0) printf "%.1f", 100 * (v - b) / b}')
+    ALLOCS=$(sed -n 's/^Alloc allocs=\([0-9]*\).*/\1/p' "$TMP.out")
+    HITS=$(sed -n 's/.*poolHits=\([0-9]*\).*/\1/p' "$TMP.out")
+    HEAP=$(sed -n 's/.*heapCalls=\([0-9]*\).*/\1/p' "$TMP.out")
+    echo "$PROG,${POOL:-n/a},$NFLOWS,$SIM_STOP,$WALL,$DWALL,$RSS,$DRSS,$ALLOCS,$HITS,$HEAP"
+    rm -f "$TMP" "$TMP.out"
+done
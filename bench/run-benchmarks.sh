@@ -0,0 +1,180 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0-only
+#
+# Suite de regressao de desempenho e resultados dos sete cenarios.
+#
+# Para cada caso de bench/cases.txt roda o binario REPEAT vezes e registra
+# tempo de parede (media e desvio), pico de RSS, eventos e eventos/s (linha
+# SimStats), percentis de RTT (linha RttStats dos cenarios TCP, uma amostra
+# por ACK recebido pela fonte) e as saidas
+# padrao e de erro do cenario (os logs do UdpEcho vao para stderr). Compara
+# com bench/baselines/<caso>:
+#   - saidas, eventos e RTT: igualdade exata (rodadas com semente fixa);
+#   - tempo: falha se media > base + max(3 * desvio_base, TIME_TOL% * base);
+#   - RSS: falha se > base * (1 + RSS_TOL%).
+# Em caso de regressao mostra um diff legivel e sai com status 1.
+#
+# Rodar a partir da raiz do ns-3, com os cenarios em scratch/ ja compilados
+# (de preferencia com --build-profile=optimized), sem rede:
+#
+#   sh scratch/bench/run-benchmarks.sh [--update] [--repeat N] [--filter PADRAO]
+#
+# --update grava as medicoes atuais como novas baselines.
+#
+# Nao ha baselines no repositorio: tempo, RSS e ate a saida dependem da
+# maquina, do compilador e da versao do ns-3. Antes do primeiro uso, numa
+# arvore considerada boa, rode com --update; sem isso todo caso falha com
+# NO BASELINE.
+#
+# O binario usado e build/scratch/ns3.<versao>-<programa>-<perfil>, com o
+# nome exato (o 1-b-pool nao e confundido com o 1-b). O perfil vem de
+# BUILD_PROFILE; sem ele, o primeiro de optimized, release, default, debug.
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+BASE_DIR="$BENCH_DIR/baselines"
+REPEAT=3
+UPDATE=0
+FILTER=""
+TIME_TOL=${TIME_TOL:-10}
+RSS_TOL=${RSS_TOL:-10}
+TIME_CMD=${TIME_CMD:-/usr/bin/time}
+PROFILES=${BUILD_PROFILE:-"optimized release default debug"}
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --update) UPDATE=1 ;;
+        --repeat) REPEAT=$2; shift ;;
+        --filter) FILTER=$2; shift ;;
+        *) echo "usage: $0 [--update] [--repeat N] [--filter PATTERN]" >&2; exit 2 ;;
+    esac
+    shift
+done
+
+command -v "$TIME_CMD" >/dev/null || { echo "/usr/bin/time (GNU time) is required" >&2; exit 2; }
+mkdir -p "$BASE_DIR"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Binario de scratch/ compilado pelo ns-3: build/scratch/ns3.<versao>-<nome>-<perfil>.
+# O nome tem que terminar em -<perfil> logo depois do programa, senao
+# "ns3*-tcp-variants-comparison-1-b-*" tambem pegaria o binario -1-b-pool.
+find_binary() {
+    for PROFILE in $PROFILES; do
+        FOUND=$(find build/scratch -maxdepth 1 -type f -perm -u+x -name "ns3*-$1-$PROFILE" 2>/dev/null |
+            head -n 1)
+        if [ -n "$FOUND" ]; then
+            echo "$FOUND"
+            return
+        fi
+    done
+}
+
+# Le "chave=valor" de um arquivo de resultados.
+value() {
+    sed -n "s/^$2=//p" "$1" | head -n 1
+}
+
+# Campo "chave=valor" da linha RttStats da saida.
+rtt_field() {
+    sed -n "s/^RttStats .* $1=\([0-9.e+-]*\).*/\1/p" "$WORK/out"
+}
+
+printf "%-14s %9s %9s %10s %12s %15s %s\n" "case" "wall(s)" "stddev" "rss(KB)" "events/s" "rtt p50/p99(ms)" "status"
+
+grep -v '^#' "$BENCH_DIR/cases.txt" | grep -v '^$' | while IFS='|' read -r NAME PROG ARGS; do
+    case "$NAME" in *"$FILTER"*) ;; *) continue ;; esac
+
+    BIN=$(find_binary "$PROG")
+    if [ -z "$BIN" ]; then
+        printf "%-14s %s\n" "$NAME" "MISSING: build '$PROG' first"
+        echo 1 >"$WORK/failed"
+        continue
+    fi
+
+    : >"$WORK/walls"
+    : >"$WORK/rss"
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        # shellcheck disable=SC2086
+        "$TIME_CMD" -f "%e %M" -o "$WORK/time" "$BIN" $ARGS </dev/null >"$WORK/out" 2>"$WORK/err"
+        awk '{print $1}' "$WORK/time" >>"$WORK/walls"
+        awk '{print $2}' "$WORK/time" >>"$WORK/rss"
+        i=$((i + 1))
+    done
+
+    CUR="$WORK/$NAME"
+    {
+        awk '{s += $1; ss += $1 * $1; n++}
+             END {m = s / n; v = ss / n - m * m; if (v < 0) v = 0;
+                  printf "wall_mean=%.4f\nwall_stddev=%.4f\n", m, sqrt(v)}' "$WORK/walls"
+        echo "peak_rss_kb=$(sort -n "$WORK/rss" | tail -n 1)"
+        echo "events=$(sed -n 's/^SimStats .*events=\([0-9]*\).*/\1/p' "$WORK/out")"
+        echo "events_per_sec=$(sed -n 's/^SimStats .*eventsPerSec=\([0-9.e+]*\).*/\1/p' "$WORK/out")"
+        echo "rtt_p50_ms=$(rtt_field p50)"
+        echo "rtt_p95_ms=$(rtt_field p95)"
+        echo "rtt_p99_ms=$(rtt_field p99)"
+        echo "--- output"
+        grep -v -e '^SimStats ' -e '^Wall=' -e '^Trace records=' -e '^RttStats ' "$WORK/out"
+        echo "--- stderr"
+        cat "$WORK/err"
+    } >"$CUR"
+
+    STATUS="ok"
+    BASE="$BASE_DIR/$NAME"
+    if [ "$UPDATE" = 1 ]; then
+        cp "$CUR" "$BASE"
+        STATUS="baseline updated"
+    elif [ ! -f "$BASE" ]; then
+        STATUS="NO BASELINE (run once with --update on a known-good tree)"
+        echo 1 >"$WORK/failed"
+    else
+        REASONS=""
+        # Saidas (stdout e stderr), eventos e RTT: igualdade exata.
+        sed -n '/^--- output$/,$p' "$BASE" >"$WORK/base.out"
+        sed -n '/^--- output$/,$p' "$CUR" >"$WORK/cur.out"
+        if ! cmp -s "$WORK/base.out" "$WORK/cur.out"; then
+            REASONS="$REASONS output"
+            echo "=== $NAME: output differs from baseline"
+            diff -u "$WORK/base.out" "$WORK/cur.out" | tail -n +3
+        fi
+        if [ "$(value "$BASE" events)" != "$(value "$CUR" events)" ]; then
+            REASONS="$REASONS events"
+            echo "=== $NAME: events $(value "$BASE" events) -> $(value "$CUR" events)"
+        fi
+        for P in p50 p95 p99; do
+            if [ "$(value "$BASE" rtt_${P}_ms)" != "$(value "$CUR" rtt_${P}_ms)" ]; then
+                REASONS="$REASONS rtt-$P"
+                echo "=== $NAME: RTT $P $(value "$BASE" rtt_${P}_ms)ms -> $(value "$CUR" rtt_${P}_ms)ms"
+            fi
+        done
+        # Tempo e memoria: tolerancia estatistica.
+        if awk -v m="$(value "$CUR" wall_mean)" -v b="$(value "$BASE" wall_mean)" \
+               -v sd="$(value "$BASE" wall_stddev)" -v tol="$TIME_TOL" \
+               'BEGIN {lim = 3 * sd; if (b * tol / 100 > lim) lim = b * tol / 100; exit !(m > b + lim)}'; then
+            REASONS="$REASONS time"
+            echo "=== $NAME: wall $(value "$BASE" wall_mean)s -> $(value "$CUR" wall_mean)s"
+        fi
+        if awk -v c="$(value "$CUR" peak_rss_kb)" -v b="$(value "$BASE" peak_rss_kb)" -v tol="$RSS_TOL" \
+               'BEGIN {exit !(c > b * (1 + tol / 100))}'; then
+            REASONS="$REASONS rss"
+            echo "=== $NAME: peak RSS $(value "$BASE" peak_rss_kb)KB -> $(value "$CUR" peak_rss_kb)KB"
+        fi
+        if [ -n "$REASONS" ]; then
+            STATUS="REGRESSION:$REASONS"
+            echo 1 >"$WORK/failed"
+        fi
+    fi
+
+    RTT="-"
+    if [ -n "$(value "$CUR" rtt_p50_ms)" ]; then
+        RTT="$(value "$CUR" rtt_p50_ms)/$(value "$CUR" rtt_p99_ms)"
+    fi
+    printf "%-14s %9s %9s %10s %12s %15s %s\n" "$NAME" "$(value "$CUR" wall_mean)" \
+        "$(value "$CUR" wall_stddev)" "$(value "$CUR" peak_rss_kb)" \
+        "$(value "$CUR" events_per_sec)" "$RTT" "$STATUS"
+done
+
+if [ -f "$WORK/failed" ]; then
+    exit 1
+fi
+exit 0
@@ -7,6 +7,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
+#include "sim-stats.h"
 
 using namespace ns3;
 
@@ -17,10 +18,14 @@ main(int argc, char* argv[])
 {
     uint32_t nClients = 1;
     uint32_t nPackets = 1;
+    bool slimStack = false;
+    bool simStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("nClients", "Escolha o número de clientes (máx: 5)", nClients);
     cmd.AddValue("nPackets", "Escolha o número de pacotes por cliente (máx: 5)", nPackets);
+    cmd.AddValue("slimStack", "Instala só a pilha IPv4 (sem IPv6)", slimStack);
+    cmd.AddValue("simStats", "Imprime tempo de parede e eventos do Simulator::Run()", simStats);
     cmd.Parse(argc, argv);
 
     //trata >5
@@ -41,7 +46,9 @@ main(int argc, char* argv[])
     pointToPoint.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
     pointToPoint.SetChannelAttribute("Delay", StringValue("2ms"));
 
+    //so IPv4: sem IPv6/ICMPv6/NDP em cada no
     InternetStackHelper stack;
+    if (slimStack) stack.SetIpv6StackInstall(false);
     stack.Install(serverNode);
     stack.Install(clientNodes);
 
@@ -90,7 +97,7 @@ main(int argc, char* argv[])
         clientApp.Stop(Seconds(20.0));
     }
 
-    Simulator::Run();
+    RunSimulation(simStats);
     Simulator::Destroy();
 
     return 0;
@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LARGE_BDP_H
+#define LARGE_BDP_H
+
+// Modo large-BDP dos cenarios dumbbell: MTU jumbo, segmento TCP do tamanho do
+// MTU (menos IPv4, TCP e timestamps) e buffers dimensionados para 2x o BDP do
+// caminho, com window scaling ligado.
+//
+// O RateErrorModel dos scripts aplica ErrorRate por byte: o padrao 1e-5
+// derruba ~8,6% dos quadros de 9000 B e o TCP fica limitado por perda a
+// poucos Mbps. Por isso, no modo large-BDP a taxa de erro padrao e 0
+// (LargeBdpErrorRate), a menos que --errorRate seja passado.
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/fatal-error.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <string>
+
+namespace ns3
+{
+
+struct LargeBdpConfig
+{
+    bool enabled;
+    std::string dataRate;    // gargalo
+    std::string accessDelay;
+    uint32_t mtu;
+
+    // IPv4 (20) + TCP (20) + timestamps (12) dentro do MTU.
+    uint32_t SegmentSize() const { return mtu - 52; }
+};
+
+// Taxa de erro efetiva no modo large-BDP: a da linha de comando, se houver, senao 0.
+inline double LargeBdpErrorRate(double errorRate, int argc, char* argv[])
+{
+    for (int a = 1; a < argc; ++a)
+        if (std::string(argv[a]).rfind("--errorRate=", 0) == 0)
+            return errorRate;
+    return 0.0;
+}
+
+// Segmento e buffers para um gargalo com atraso delay. Os sockets so sao
+// criados no Simulator::Run(), entao pode ser chamado de novo por ponto de
+// varredura antes de rodar.
+inline void ConfigureLargeBdpBuffers(const LargeBdpConfig& cfg, const std::string& delay)
+{
+    double rtt = 2.0 * (Time(delay).GetSeconds() + 2.0 * Time(cfg.accessDelay).GetSeconds());
+    uint64_t bdp = static_cast<uint64_t>(DataRate(cfg.dataRate).GetBitRate() / 8.0 * rtt);
+    uint32_t buf = std::min<uint64_t>(std::max<uint64_t>(2 * bdp, 131072), 0x3fffffff);
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(cfg.SegmentSize()));
+    Config::SetDefault("ns3::TcpSocket::SndBufSize", UintegerValue(buf));
+    Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(buf));
+    Config::SetDefault("ns3::TcpSocketBase::WindowScaling", BooleanValue(true));
+}
+
+// Configuracao completa, antes de montar a topologia: buffers, MTU dos
+// devices e enlace de acesso acima do gargalo (o acesso nao pode virar o
+// gargalo). Devolve o SendSize das aplicacoes.
+inline uint32_t ConfigureLargeBdp(const LargeBdpConfig& cfg, const std::string& delay, std::string& accessRate)
+{
+    if (cfg.mtu <= 52)
+        NS_FATAL_ERROR("--mtu must be larger than 52 (IPv4 + TCP + timestamps), got " << cfg.mtu);
+    ConfigureLargeBdpBuffers(cfg, delay);
+    Config::SetDefault("ns3::PointToPointNetDevice::Mtu", UintegerValue(cfg.mtu));
+    if (DataRate(accessRate) <= DataRate(cfg.dataRate))
+        accessRate = std::to_string(2 * DataRate(cfg.dataRate).GetBitRate()) + "bps";
+    return cfg.SegmentSize();
+}
+
+} // namespace ns3
+
+#endif // LARGE_BDP_H
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+// Pool de memoria para Packet, Buffer, headers e tags.
+//
+// Tambem contabiliza os bytes vivos alocados pela thread do simulador, o que
+// permite medir quanto cada fase da montagem do cenario custa por no.
+//
+// So tem efeito compilado com PACKET_POOL definido: ai substitui o operator
+// new/delete global do programa (incluir em um unico .cc por executavel).
+// Sem PACKET_POOL o alocador padrao fica intacto, Attach() nao faz nada e as
+// estatisticas ficam zeradas (kEnabled = false).
+//
+// Blocos pequenos levam um cabecalho com a classe de tamanho; com o pool
+// ligado, o delete devolve o bloco a lista livre da classe e o proximo new
+// do mesmo tamanho o reaproveita sem chamar malloc.
+// Em regime permanente (pacotes criados no envio e destruidos no sink) nao
+// ha chamadas ao heap. So a thread que chamou Attach() usa o pool; as demais
+// vao direto ao malloc/free.
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace packetpool
+{
+
+struct Stats
+{
+    uint64_t allocs = 0;    // operator new na thread do pool
+    uint64_t hits = 0;      // atendidos pela lista livre
+    uint64_t misses = 0;    // foram ao malloc
+    uint64_t releases = 0;  // blocos devolvidos a lista livre
+    int64_t liveBytes = 0;  // bytes pedidos e ainda nao liberados
+};
+
+#ifndef PACKET_POOL
+
+constexpr bool kEnabled = false;
+
+inline void Attach(bool)
+{
+}
+
+inline const Stats& GetStats()
+{
+    static const Stats none;
+    return none;
+}
+
+} // namespace packetpool
+
+#else
+
+constexpr bool kEnabled = true;
+constexpr std::size_t kHeader = 16;
+constexpr std::size_t kGranularity = 16;
+constexpr std::size_t kMaxPooled = 2048;
+constexpr std::size_t kClasses = kMaxPooled / kGranularity + 1;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+inline Stats g_stats;
+inline bool g_pooling = false;
+inline FreeBlock* g_freeList[kClasses] = {};
+inline thread_local bool t_attached = false;
+
+// Cabecalho de cada bloco: [classe de tamanho][tamanho pedido]. O bit alto
+// do tamanho marca blocos contados em liveBytes (alocados na thread ligada
+// depois do Attach()); so esses sao descontados no delete, entao blocos de
+// antes do Attach() ou de outras threads (buffers do AsyncWriter) nao deixam
+// as fases negativas.
+static_assert(kHeader >= 2 * sizeof(std::size_t), "header too small");
+constexpr std::size_t kCounted = ~(~std::size_t(0) >> 1);
+
+// Liga a contabilidade (e o reaproveitamento, se pooling) na thread atual,
+// que deve ser a do simulador.
+inline void Attach(bool pooling)
+{
+    t_attached = true;
+    g_pooling = pooling;
+}
+
+inline const Stats& GetStats()
+{
+    return g_stats;
+}
+
+inline std::size_t SizeClass(std::size_t size)
+{
+    if (size > kMaxPooled)
+        return 0;
+    return (size + kGranularity - 1) / kGranularity + (size == 0);
+}
+
+inline void* Allocate(std::size_t size) noexcept
+{
+    std::size_t cls = SizeClass(size);
+    if (t_attached)
+    {
+        ++g_stats.allocs;
+        if (g_pooling && cls != 0 && g_freeList[cls])
+        {
+            FreeBlock* b = g_freeList[cls];
+            g_freeList[cls] = b->next;
+            ++g_stats.hits;
+            g_stats.liveBytes += size;
+            reinterpret_cast<std::size_t*>(b)[-1] = size | kCounted;
+            return b;
+        }
+        ++g_stats.misses;
+        g_stats.liveBytes += size;
+    }
+    std::size_t bytes = cls != 0 ? cls * kGranularity : size;
+    char* raw = static_cast<char*>(std::malloc(bytes + kHeader));
+    if (!raw)
+        return nullptr;
+    reinterpret_cast<std::size_t*>(raw)[0] = cls;
+    reinterpret_cast<std::size_t*>(raw)[1] = t_attached ? size | kCounted : size;
+    return raw + kHeader;
+}
+
+inline void Release(void* p) noexcept
+{
+    if (!p)
+        return;
+    char* raw = static_cast<char*>(p) - kHeader;
+    std::size_t cls = reinterpret_cast<std::size_t*>(raw)[0];
+    std::size_t size = reinterpret_cast<std::size_t*>(raw)[1];
+    if (t_attached && (size & kCounted))
+        g_stats.liveBytes -= size & ~kCounted;
+    if (t_attached && g_pooling && cls != 0)
+    {
+        FreeBlock* b = static_cast<FreeBlock*>(p);
+        b->next = g_freeList[cls];
+        g_freeList[cls] = b;
+        ++g_stats.releases;
+        return;
+    }
+    std::free(raw);
+}
+
+} // namespace packetpool
+
+// noinline: evita que o GCC veja o cabecalho escondido atraves do new/delete
+// inlinados e acuse falsos -Warray-bounds/-Wmismatched-new-delete.
+[[gnu::noinline]] void*
+operator new(std::size_t size)
+{
+    void* p = packetpool::Allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+[[gnu::noinline]] void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+[[gnu::noinline]] void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return packetpool::Allocate(size);
+}
+
+[[gnu::noinline]] void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return packetpool::Allocate(size);
+}
+
+[[gnu::noinline]] void
+operator delete(void* p) noexcept
+{
+    packetpool::Release(p);
+}
+
+[[gnu::noinline]] void
+operator delete[](void* p) noexcept
+{
+    packetpool::Release(p);
+}
+
+[[gnu::noinline]] void
+operator delete(void* p, std::size_t) noexcept
+{
+    packetpool::Release(p);
+}
+
+[[gnu::noinline]] void
+operator delete[](void* p, std::size_t) noexcept
+{
+    packetpool::Release(p);
+}
+
+[[gnu::noinline]] void
+operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    packetpool::Release(p);
+}
+
+[[gnu::noinline]] void
+operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    packetpool::Release(p);
+}
+
+#endif // PACKET_POOL
+
+#endif // PACKET_POOL_H
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/core-module.h"
+#include "scenario-results.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ResultsExport");
+
+// Exporta um arquivo de resultados (scenario-results.h) para os layouts CSV
+// antigos: goodput_vs_delay.csv, goodput_vs_error.csv e rtt_fairness.csv.
+
+int main(int argc, char* argv[])
+{
+    std::string in = "";
+    std::string out = "";
+    std::string layout = "delay";
+    std::string scenario = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("in", "Results file to read", in);
+    cmd.AddValue("out", "CSV output file (default: stdout)", out);
+    cmd.AddValue("layout", "CSV layout: delay, error or rtt", layout);
+    cmd.AddValue("scenario", "Only export rows of this scenario (default: the layout's script)", scenario);
+    cmd.Parse(argc, argv);
+
+    if (in.empty())
+    {
+        std::cerr << "--in is required" << std::endl;
+        return 1;
+    }
+    if (layout != "delay" && layout != "error" && layout != "rtt")
+    {
+        std::cerr << "unknown layout " << layout << std::endl;
+        return 1;
+    }
+    // Cada layout antigo vem de um script; arquivos com varios cenarios sao filtrados.
+    if (scenario.empty())
+        scenario = layout == "delay" ? "tcp-variants-1b" : layout == "error" ? "tcp-variants-1c" : "tcp-variants-2";
+
+    results::ResultReader reader(in);
+    const std::size_t cScenario = reader.FindColumn("scenario");
+    const std::size_t cProt = reader.FindColumn("protocol");
+    const std::size_t cNFlows = reader.FindColumn("nFlows");
+    const std::size_t cFlow = reader.FindColumn("flow");
+    const std::size_t cDelay = reader.FindColumn("delay_ms");
+    const std::size_t cError = reader.FindColumn("error_rate");
+    const std::size_t cGoodput = reader.FindColumn("goodput_mbps");
+
+    std::ofstream file;
+    if (!out.empty())
+        file.open(out);
+    std::ostream& os = out.empty() ? std::cout : file;
+
+    if (layout == "delay")
+        os << "Protocol,nFlows,Delay(ms),Goodput(Mbps)\n";
+    else if (layout == "error")
+        os << "Protocol,nFlows,ErrorRate,Goodput(Mbps)\n";
+    else
+        os << "Protocol,Delay1,Delay2,Goodput1(Mbps),Goodput2(Mbps)\n";
+
+    // Cada execucao ocupa nFlows linhas consecutivas, comecando em flow == 0.
+    std::size_t row = 0;
+    while (row < reader.GetNRows())
+    {
+        if (reader.GetInt(row, cFlow) != 0 || reader.GetText(row, cScenario) != scenario)
+        {
+            ++row;
+            continue;
+        }
+        std::size_t n = reader.GetInt(row, cNFlows);
+        if (n == 0 || row + n > reader.GetNRows())
+            break;
+
+        std::string prot = reader.GetText(row, cProt);
+        if (layout == "rtt")
+        {
+            os << prot << ","
+               << reader.GetReal(row, cDelay) << "ms,"
+               << (n > 1 ? reader.GetReal(row + 1, cDelay) : 0.0) << "ms,"
+               << reader.GetReal(row, cGoodput) << ","
+               << (n > 1 ? reader.GetReal(row + 1, cGoodput) : 0.0) << "\n";
+        }
+        else
+        {
+            double agg = 0.0;
+            for (std::size_t f = 0; f < n; ++f)
+                agg += reader.GetReal(row + f, cGoodput);
+            os << prot << "," << n << ",";
+            if (layout == "delay")
+                os << reader.GetReal(row, cDelay);
+            else
+                os << reader.GetReal(row, cError);
+            os << "," << agg << "\n";
+        }
+        row += n;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RTT_STATS_H
+#define RTT_STATS_H
+
+// Percentis de RTT dos fluxos TCP de um no, uma amostra por ACK recebido:
+// o valor do trace "RTT" do TcpSocketBase depois de processado o ACK. Imprime
+// "RttStats acks=<n> p50=<ms> p95=<ms> p99=<ms>", linha lida pelo
+// bench/run-benchmarks.sh.
+//
+// O TracedValue "RTT" so dispara quando o valor muda, entao nao serve sozinho
+// de fonte de amostras. O trace "Rx" dispara em todo segmento recebido (na
+// fonte do BulkSend, todo ACK), mas antes do ACK atualizar o RTT. Por isso
+// cada Rx deixa uma amostra pendente: se o ACK muda o RTT, o trace "RTT"
+// grava o valor novo; senao, o proximo Rx (ou o Print) grava o valor atual.
+
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-socket-base.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class RttStats
+{
+  public:
+    // Conecta todos os sockets TCP do no; chamar depois do Start dos BulkSend,
+    // quando os sockets ja existem (os scripts usam 1.01 s, como no cwnd).
+    void Connect(uint32_t nodeId)
+    {
+        std::string sockets =
+            "/NodeList/" + std::to_string(nodeId) + "/$ns3::TcpL4Protocol/SocketList/*/";
+        Config::Connect(sockets + "RTT", MakeCallback(&RttStats::RttChanged, this));
+        Config::Connect(sockets + "Rx", MakeCallback(&RttStats::SegmentReceived, this));
+    }
+
+    void Print()
+    {
+        for (auto& s : m_sockets)
+            Flush(s.second);
+        std::sort(m_samples.begin(), m_samples.end());
+        std::cout << "RttStats acks=" << m_samples.size()
+                  << " p50=" << Percentile(50)
+                  << " p95=" << Percentile(95)
+                  << " p99=" << Percentile(99) << std::endl;
+    }
+
+  private:
+    struct Socket
+    {
+        double rtt = 0.0;      // ms
+        bool known = false;    // ja houve alguma amostra de RTT
+        bool pending = false;  // ACK recebido ainda sem amostra gravada
+    };
+
+    // Contexto ".../SocketList/<i>/<trace>" -> socket.
+    Socket& Find(const std::string& context)
+    {
+        return m_sockets[context.substr(0, context.rfind('/'))];
+    }
+
+    void Flush(Socket& s)
+    {
+        if (s.pending && s.known)
+            m_samples.push_back(s.rtt);
+        s.pending = false;
+    }
+
+    void SegmentReceived(std::string context,
+                         Ptr<const Packet>,
+                         const TcpHeader&,
+                         Ptr<const TcpSocketBase>)
+    {
+        Socket& s = Find(context);
+        Flush(s);
+        s.pending = true;
+    }
+
+    void RttChanged(std::string context, Time, Time newval)
+    {
+        Socket& s = Find(context);
+        s.rtt = newval.GetSeconds() * 1000.0;
+        s.known = true;
+        Flush(s);
+    }
+
+    // Nearest-rank sobre as amostras ja ordenadas.
+    double Percentile(double p) const
+    {
+        if (m_samples.empty())
+            return 0.0;
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * m_samples.size()));
+        return m_samples[std::max<std::size_t>(rank, 1) - 1];
+    }
+
+    std::map<std::string, Socket> m_sockets;
+    std::vector<double> m_samples;
+};
+
+} // namespace ns3
+
+#endif // RTT_STATS_H
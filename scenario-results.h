@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCENARIO_RESULTS_H
+#define SCENARIO_RESULTS_H
+
+// Armazenamento de resultados comum aos scripts de cenario.
+//
+// Arquivo binario tipado com versao de esquema: um cabecalho descreve as
+// colunas (nome + tipo) e cada linha e um registro de largura fixa, de modo
+// que novas execucoes so fazem append e a leitura pode ser feita via mmap
+// com acesso direto por (linha, coluna).
+//
+// So ha o esquema por fluxo (um goodput por fluxo por execucao). Series
+// temporais (cwnd, RTT ao longo do tempo) continuam nos arquivos .data de
+// cada script; nao ha esquema para elas aqui.
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace results
+{
+
+constexpr char kMagic[8] = {'N', 'S', '3', 'R', 'E', 'S', '\0', '\0'};
+constexpr uint32_t kSchemaVersion = 1;
+constexpr std::size_t kTextWidth = 32;
+
+enum class ColumnType : uint8_t
+{
+    Int = 1,
+    Real = 2,
+    Text = 3,
+};
+
+struct Column
+{
+    std::string name;
+    ColumnType type;
+};
+
+inline std::size_t ColumnWidth(ColumnType type)
+{
+    return type == ColumnType::Text ? kTextWidth : 8;
+}
+
+// Esquema compartilhado pelos cenarios TCP: uma linha por fluxo por execucao.
+// delay_ms e o atraso que o cenario varia (gargalo ou acesso do fluxo).
+inline const std::vector<Column>& FlowSchema()
+{
+    static const std::vector<Column> schema = {
+        {"scenario", ColumnType::Text},
+        {"protocol", ColumnType::Text},
+        {"seed", ColumnType::Int},
+        {"run", ColumnType::Int},
+        {"nFlows", ColumnType::Int},
+        {"flow", ColumnType::Int},
+        {"delay_ms", ColumnType::Real},
+        {"error_rate", ColumnType::Real},
+        {"goodput_mbps", ColumnType::Real},
+    };
+    return schema;
+}
+
+inline std::string EncodeHeader(const std::vector<Column>& columns)
+{
+    std::string h(kMagic, sizeof(kMagic));
+    uint32_t version = kSchemaVersion;
+    uint32_t n = columns.size();
+    h.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    h.append(reinterpret_cast<const char*>(&n), sizeof(n));
+    for (const auto& c : columns)
+    {
+        h.push_back(static_cast<char>(c.type));
+        h.push_back(static_cast<char>(c.name.size()));
+        h.append(c.name);
+    }
+    h.resize((h.size() + 7) & ~std::size_t(7), '\0');
+    return h;
+}
+
+// Valor de uma celula; o tipo efetivo vem do esquema.
+struct Value
+{
+    Value(int64_t v) : i(v) {}
+    Value(int v) : i(v) {}
+    Value(uint32_t v) : i(v) {}
+    Value(uint64_t v) : i(static_cast<int64_t>(v)) {}
+    Value(double v) : isReal(true), r(v) {}
+    Value(const char* v) : s(v) {}
+    Value(std::string v) : s(std::move(v)) {}
+
+    int64_t AsInt() const { return isReal ? static_cast<int64_t>(r) : i; }
+    double AsReal() const { return isReal ? r : static_cast<double>(i); }
+
+    bool isReal = false;
+    int64_t i = 0;
+    double r = 0.0;
+    std::string s;
+};
+
+class ResultWriter
+{
+  public:
+    // Abre (ou cria) o arquivo; se ja existir, o cabecalho tem que bater.
+    ResultWriter(const std::string& path, const std::vector<Column>& columns)
+        : m_columns(columns)
+    {
+        m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (m_fd < 0)
+            throw std::runtime_error("results: cannot open " + path);
+
+        std::string header = EncodeHeader(columns);
+        struct stat st;
+        fstat(m_fd, &st);
+        if (st.st_size == 0)
+        {
+            if (write(m_fd, header.data(), header.size()) != static_cast<ssize_t>(header.size()))
+                throw std::runtime_error("results: cannot write header to " + path);
+        }
+        else
+        {
+            std::string existing(header.size(), '\0');
+            if (pread(m_fd, &existing[0], existing.size(), 0) != static_cast<ssize_t>(existing.size()) ||
+                existing != header)
+                throw std::runtime_error("results: schema mismatch in " + path);
+        }
+    }
+
+    // Destrutor nao pode lancar: falha no ultimo Flush() so e reportada em
+    // stderr. Quem precisa tratar o erro chama Flush() antes.
+    ~ResultWriter()
+    {
+        try
+        {
+            Flush();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+        if (m_fd >= 0)
+            close(m_fd);
+    }
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    void AddRow(const std::vector<Value>& row)
+    {
+        if (row.size() != m_columns.size())
+            throw std::runtime_error("results: row has wrong number of columns");
+        for (std::size_t c = 0; c < row.size(); ++c)
+        {
+            switch (m_columns[c].type)
+            {
+            case ColumnType::Int: {
+                int64_t i = row[c].AsInt();
+                m_pending.append(reinterpret_cast<const char*>(&i), 8);
+                break;
+            }
+            case ColumnType::Real: {
+                double r = row[c].AsReal();
+                m_pending.append(reinterpret_cast<const char*>(&r), 8);
+                break;
+            }
+            case ColumnType::Text: {
+                std::string t = row[c].s.substr(0, kTextWidth - 1);
+                t.resize(kTextWidth, '\0');
+                m_pending.append(t);
+                break;
+            }
+            }
+        }
+    }
+
+    // Grava as linhas pendentes com um unico write(): com O_APPEND, processos
+    // filhos (modo fork) podem gravar no mesmo arquivo sem intercalar linhas.
+    void Flush()
+    {
+        if (m_pending.empty() || m_fd < 0)
+            return;
+        if (write(m_fd, m_pending.data(), m_pending.size()) != static_cast<ssize_t>(m_pending.size()))
+            throw std::runtime_error("results: short write");
+        m_pending.clear();
+    }
+
+  private:
+    std::vector<Column> m_columns;
+    std::string m_pending;
+    int m_fd = -1;
+};
+
+// Leitura via mmap, sem copiar as linhas para a memoria do processo.
+class ResultReader
+{
+  public:
+    explicit ResultReader(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("results: cannot open " + path);
+        struct stat st;
+        fstat(fd, &st);
+        m_size = st.st_size;
+        if (m_size > 0)
+            m_base = static_cast<const char*>(mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0));
+        close(fd);
+        if (m_base == MAP_FAILED)
+            m_base = nullptr;
+        if (m_size < 16 || !m_base || std::memcmp(m_base, kMagic, sizeof(kMagic)) != 0)
+            Fail("not a results file: " + path);
+
+        uint32_t n;
+        std::memcpy(&m_version, m_base + 8, 4);
+        std::memcpy(&n, m_base + 12, 4);
+        if (m_version != kSchemaVersion)
+            Fail("unsupported schema version in " + path);
+
+        std::size_t off = 16;
+        for (uint32_t c = 0; c < n; ++c)
+        {
+            if (off + 2 > m_size)
+                Fail("truncated header in " + path);
+            Column col;
+            col.type = static_cast<ColumnType>(m_base[off]);
+            std::size_t len = static_cast<uint8_t>(m_base[off + 1]);
+            if (off + 2 + len > m_size)
+                Fail("truncated header in " + path);
+            col.name.assign(m_base + off + 2, len);
+            off += 2 + len;
+            m_offsets.push_back(m_rowSize);
+            m_rowSize += ColumnWidth(col.type);
+            m_columns.push_back(col);
+        }
+        m_dataOffset = (off + 7) & ~std::size_t(7);
+        m_rows = m_rowSize > 0 && m_size > m_dataOffset ? (m_size - m_dataOffset) / m_rowSize : 0;
+    }
+
+    ~ResultReader()
+    {
+        if (m_base)
+            munmap(const_cast<char*>(m_base), m_size);
+    }
+
+    ResultReader(const ResultReader&) = delete;
+    ResultReader& operator=(const ResultReader&) = delete;
+
+    uint32_t GetSchemaVersion() const { return m_version; }
+    std::size_t GetNRows() const { return m_rows; }
+    const std::vector<Column>& GetColumns() const { return m_columns; }
+
+    std::size_t FindColumn(const std::string& name) const
+    {
+        for (std::size_t c = 0; c < m_columns.size(); ++c)
+            if (m_columns[c].name == name)
+                return c;
+        throw std::runtime_error("results: no column " + name);
+    }
+
+    int64_t GetInt(std::size_t row, std::size_t col) const
+    {
+        int64_t v;
+        std::memcpy(&v, Cell(row, col), 8);
+        return v;
+    }
+
+    double GetReal(std::size_t row, std::size_t col) const
+    {
+        double v;
+        std::memcpy(&v, Cell(row, col), 8);
+        return v;
+    }
+
+    std::string GetText(std::size_t row, std::size_t col) const
+    {
+        const char* p = Cell(row, col);
+        return std::string(p, strnlen(p, kTextWidth));
+    }
+
+  private:
+    [[noreturn]] void Fail(const std::string& msg)
+    {
+        if (m_base)
+            munmap(const_cast<char*>(m_base), m_size);
+        m_base = nullptr;
+        throw std::runtime_error("results: " + msg);
+    }
+
+    const char* Cell(std::size_t row, std::size_t col) const
+    {
+        return m_base + m_dataOffset + row * m_rowSize + m_offsets[col];
+    }
+
+    const char* m_base = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_dataOffset = 0;
+    std::size_t m_rowSize = 0;
+    std::size_t m_rows = 0;
+    uint32_t m_version = 0;
+    std::vector<Column> m_columns;
+    std::vector<std::size_t> m_offsets;
+};
+
+} // namespace results
+
+#endif // SCENARIO_RESULTS_H
@@ -0,0 +1,728 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/error-model.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+#include "async-writer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ScenarioRunner");
+
+// Executa um cenario descrito em arquivo (scenarios/*.scn) em vez de um main()
+// por topologia. Uma diretiva por linha, '#' comenta:
+//
+//   var nome=valor                       variavel, usada como ${nome}
+//   sweep nome=v1,v2,...                 eixo de varredura (um processo por ponto)
+//   config ns3::Classe::Atributo=valor   Config::SetDefault
+//   log Componente                       LogComponentEnable(..., LOG_LEVEL_INFO)
+//   node nome [count=N]                  N > 1 cria nome0..nome{N-1} (grupo)
+//   stack [errorModels=after|before]     onde os modelos de erro sao criados
+//                                        em relacao a pilha (padrao: depois)
+//   link a b rate=R delay=D [errorRate=E]   um enlace p2p por membro de a x b
+//   queue a b disc=ns3::TipoQueueDisc [maxSize=S]
+//                                        queue disc raiz nos devices do enlace
+//                                        a b (senao vale o padrao do
+//                                        Ipv4AddressHelper, como nos scripts)
+//   bulk from=no to=grupo port=P [sendSize= maxBytes= start= stop= sinkStart=]
+//   echo server=no clients=grupo port=P [packets= interval= size= start=a[:b]
+//        stop= serverStart= serverStop=]
+//   trace cwnd node=no file=F [start=T]  cwnd dos sockets TCP do no, no formato
+//                                        do 1-a, via AsyncWriter (padrao 1.01 s)
+//   stop T                               Simulator::Stop(Seconds(T))
+//
+// from, server e node sao nos simples (sem count); grupos so em to/clients.
+//
+// A ordem de criacao (nos, pilha, modelos de erro, enlaces, queue discs,
+// enderecos, rotas, aplicacoes) segue os scripts, para os numeros (goodput e
+// traces) sairem iguais; o 1-a cria o modelo de erro antes da pilha (stack
+// errorModels=before). A saida padrao tem formato proprio, nao a dos scripts.
+// Cada enlace recebe uma rede /24 nova a partir de 10.1.1.0, na ordem do
+// arquivo.
+//
+// So ha enlaces p2p: scenarios/ cobre o first.cc e os quatro tcp-variants; o
+// second.cc (CSMA) e o third.cc (Wi-Fi) nao sao expressaveis, nem traces
+// alem do cwnd. O arquivo e sempre lido como texto; nao ha forma binaria
+// pre-processada.
+
+struct Directive
+{
+    uint32_t line;
+    std::string kind;
+    std::vector<std::string> args;
+    std::map<std::string, std::string> kv;
+};
+
+struct Scenario
+{
+    std::vector<std::pair<std::string, std::string>> vars;
+    std::vector<std::pair<std::string, std::vector<std::string>>> sweeps;
+    std::vector<Directive> directives;
+};
+
+static std::vector<std::string> Split(const std::string& s, char sep)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, sep))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+static bool ParseScenario(const std::string& path, Scenario& scn, std::vector<std::string>& errors)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        errors.push_back("cannot open " + path);
+        return false;
+    }
+    std::string text;
+    uint32_t lineNo = 0;
+    while (std::getline(in, text))
+    {
+        ++lineNo;
+        text = text.substr(0, text.find('#'));
+        std::istringstream tokens(text);
+        Directive d;
+        d.line = lineNo;
+        if (!(tokens >> d.kind))
+            continue;
+        std::string tok;
+        while (tokens >> tok)
+        {
+            std::size_t eq = tok.find('=');
+            if (eq == std::string::npos)
+                d.args.push_back(tok);
+            else
+                d.kv[tok.substr(0, eq)] = tok.substr(eq + 1);
+        }
+        if (d.kind == "var" || d.kind == "sweep")
+        {
+            if (d.kv.size() != 1 || !d.args.empty())
+            {
+                errors.push_back("line " + std::to_string(lineNo) + ": expected " + d.kind +
+                                 " name=value");
+                continue;
+            }
+            if (d.kind == "var")
+                scn.vars.push_back(*d.kv.begin());
+            else
+                scn.sweeps.push_back({d.kv.begin()->first, Split(d.kv.begin()->second, ',')});
+            continue;
+        }
+        scn.directives.push_back(d);
+    }
+    return errors.empty();
+}
+
+static std::string Substitute(const std::string& s,
+                              const std::map<std::string, std::string>& vars,
+                              uint32_t line,
+                              std::vector<std::string>& errors)
+{
+    std::string out;
+    std::size_t pos = 0;
+    while (true)
+    {
+        std::size_t start = s.find("${", pos);
+        if (start == std::string::npos)
+            break;
+        std::size_t end = s.find('}', start);
+        if (end == std::string::npos)
+            break;
+        out += s.substr(pos, start - pos);
+        std::string name = s.substr(start + 2, end - start - 2);
+        auto it = vars.find(name);
+        if (it == vars.end())
+            errors.push_back("line " + std::to_string(line) + ": undefined variable " + name);
+        else
+            out += it->second;
+        pos = end + 1;
+    }
+    return out + s.substr(pos);
+}
+
+// Aplica as variaveis (valores do arquivo, depois sobrescritas) em todas as diretivas.
+static std::vector<Directive> Resolve(const Scenario& scn,
+                                      const std::map<std::string, std::string>& overrides,
+                                      std::vector<std::string>& errors)
+{
+    std::map<std::string, std::string> vars(scn.vars.begin(), scn.vars.end());
+    for (const auto& o : overrides)
+        vars[o.first] = o.second;
+
+    std::vector<Directive> resolved = scn.directives;
+    for (auto& d : resolved)
+    {
+        for (auto& a : d.args)
+            a = Substitute(a, vars, d.line, errors);
+        for (auto& kv : d.kv)
+            kv.second = Substitute(kv.second, vars, d.line, errors);
+    }
+    return resolved;
+}
+
+static bool IsNumber(const std::string& s)
+{
+    std::istringstream in(s);
+    double v;
+    return (in >> v) && in.eof();
+}
+
+// Inteiros que vao para std::stoul: so digitos, sem sinal nem fracao.
+static bool IsUnsigned(const std::string& s)
+{
+    return !s.empty() && s.size() <= 18 && s.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// config ns3::Classe::Atributo=valor: classe, atributo e valor checados sem
+// mudar nenhum default (Config::SetDefault aborta em nome ou valor invalido).
+static bool IsValidConfig(const std::string& name, const std::string& value, std::string& why)
+{
+    std::size_t sep = name.rfind("::");
+    TypeId tid;
+    TypeId::AttributeInformation info;
+    if (sep == std::string::npos || !TypeId::LookupByNameFailSafe(name.substr(0, sep), &tid))
+        why = "unknown class in " + name;
+    else if (!tid.LookupAttributeByName(name.substr(sep + 2), &info))
+        why = "unknown attribute " + name;
+    else if (!info.checker->CreateValidValue(StringValue(value)))
+        why = "bad value for " + name + ": " + value;
+    else
+        return true;
+    return false;
+}
+
+// Checagens locais: o parser de Time do ns-3 aborta em vez de devolver erro.
+static bool IsNumberWithUnit(const std::string& s, const std::set<std::string>& units)
+{
+    const char* begin = s.c_str();
+    char* end = nullptr;
+    std::strtod(begin, &end);
+    return end != begin && units.count(std::string(end));
+}
+
+static bool IsTime(const std::string& s)
+{
+    return IsNumberWithUnit(s, {"", "s", "ms", "us", "ns", "ps", "fs", "min", "h", "d", "y"});
+}
+
+static bool IsDataRate(const std::string& s)
+{
+    return IsNumberWithUnit(s,
+                            {"", "bps", "b/s", "Bps", "B/s", "kbps", "kb/s", "Kbps", "Kb/s",
+                             "kBps", "kB/s", "KBps", "KB/s", "Kibps", "KiBps", "Mbps", "Mb/s",
+                             "MBps", "MB/s", "Mibps", "MiBps", "Gbps", "Gb/s", "GBps", "GB/s",
+                             "Gibps", "GiBps"});
+}
+
+static std::string Get(const Directive& d, const std::string& key, const std::string& def)
+{
+    auto it = d.kv.find(key);
+    return it == d.kv.end() ? def : it->second;
+}
+
+// Validador: diretivas e chaves conhecidas, nos declarados antes do uso,
+// numeros, tempos e taxas bem formados.
+static void Validate(const std::vector<Directive>& directives, std::vector<std::string>& errors)
+{
+    static const std::map<std::string, std::vector<std::string>> keys = {
+        {"config", {}},
+        {"log", {}},
+        {"node", {"count"}},
+        {"stack", {"errorModels"}},
+        {"link", {"rate", "delay", "errorRate"}},
+        {"queue", {"disc", "maxSize"}},
+        {"trace", {"node", "file", "start"}},
+        {"bulk", {"from", "to", "port", "sendSize", "maxBytes", "start", "stop", "sinkStart"}},
+        {"echo",
+         {"server", "clients", "port", "packets", "interval", "size", "start", "stop",
+          "serverStart", "serverStop"}},
+        {"stop", {}},
+    };
+    static const std::map<std::string, std::vector<std::string>> required = {
+        {"link", {"rate", "delay"}},
+        {"queue", {"disc"}},
+        {"trace", {"node", "file"}},
+        {"bulk", {"from", "to", "port"}},
+        {"echo", {"server", "clients", "port"}},
+    };
+
+    std::map<std::string, uint32_t> nodes;  // nome -> count
+    std::set<std::pair<std::string, std::string>> links;
+    uint32_t stacks = 0;
+    for (const auto& d : directives)
+    {
+        std::string at = "line " + std::to_string(d.line) + ": ";
+        auto known = keys.find(d.kind);
+        if (known == keys.end())
+        {
+            errors.push_back(at + "unknown directive " + d.kind);
+            continue;
+        }
+        if (d.kind != "config")
+            for (const auto& kv : d.kv)
+                if (std::find(known->second.begin(), known->second.end(), kv.first) ==
+                    known->second.end())
+                    errors.push_back(at + "unknown key " + kv.first + " for " + d.kind);
+        auto req = required.find(d.kind);
+        if (req != required.end())
+            for (const auto& k : req->second)
+                if (!d.kv.count(k))
+                    errors.push_back(at + d.kind + " requires " + k);
+
+        auto checkNode = [&](const std::string& name) {
+            if (!nodes.count(name))
+                errors.push_back(at + "undeclared node " + name);
+        };
+        // O runner usa Get(0) nesses papeis; um grupo perderia membros em silencio.
+        auto checkSingle = [&](const char* key) {
+            auto it = d.kv.find(key);
+            if (it != d.kv.end() && nodes.count(it->second) && nodes.at(it->second) > 1)
+                errors.push_back(at + key + " must be a single node, " + it->second + " is a group");
+        };
+        auto checkNumber = [&](const char* key) {
+            auto it = d.kv.find(key);
+            if (it != d.kv.end() && !IsNumber(it->second))
+                errors.push_back(at + key + " is not a number: " + it->second);
+        };
+        auto checkUnsigned = [&](const char* key) {
+            auto it = d.kv.find(key);
+            if (it != d.kv.end() && !IsUnsigned(it->second))
+                errors.push_back(at + key + " is not a non-negative integer: " + it->second);
+        };
+
+        std::string why;
+        if (d.kind == "config" && (d.kv.size() != 1 || !d.args.empty()))
+            errors.push_back(at + "expected config ns3::Class::Attribute=value");
+        else if (d.kind == "config" && !IsValidConfig(d.kv.begin()->first, d.kv.begin()->second, why))
+            errors.push_back(at + why);
+        else if (d.kind == "log" && d.args.size() != 1)
+            errors.push_back(at + "expected log <component>");
+        else if (d.kind == "log" && !LogComponent::GetComponentList()->count(d.args[0]))
+            errors.push_back(at + "unknown log component " + d.args[0]);
+        else if (d.kind == "stop" && (d.args.size() != 1 || !IsNumber(d.args[0])))
+            errors.push_back(at + "expected stop <seconds>");
+        else if (d.kind == "stack")
+        {
+            if (!d.args.empty())
+                errors.push_back(at + "expected stack [errorModels=after|before]");
+            if (d.kv.count("errorModels") && d.kv.at("errorModels") != "after" &&
+                d.kv.at("errorModels") != "before")
+                errors.push_back(at + "errorModels must be after or before");
+            if (++stacks > 1)
+                errors.push_back(at + "duplicate stack");
+        }
+        else if (d.kind == "node")
+        {
+            if (d.args.size() != 1)
+                errors.push_back(at + "expected node <name>");
+            else if (nodes.count(d.args[0]))
+                errors.push_back(at + "duplicate node " + d.args[0]);
+            bool countOk = !d.kv.count("count") ||
+                           (IsUnsigned(d.kv.at("count")) && std::stoul(d.kv.at("count")) > 0);
+            if (!countOk)
+                errors.push_back(at + "count must be a positive integer: " + d.kv.at("count"));
+            if (d.args.size() == 1 && !nodes.count(d.args[0]))
+                nodes[d.args[0]] = countOk ? std::stoul(Get(d, "count", "1")) : 1;
+        }
+        else if (d.kind == "link")
+        {
+            if (d.args.size() != 2)
+                errors.push_back(at + "expected link <a> <b>");
+            for (const auto& n : d.args)
+                checkNode(n);
+            if (d.kv.count("rate") && !IsDataRate(d.kv.at("rate")))
+                errors.push_back(at + "bad rate " + d.kv.at("rate"));
+            if (d.kv.count("delay") && !IsTime(d.kv.at("delay")))
+                errors.push_back(at + "bad delay " + d.kv.at("delay"));
+            checkNumber("errorRate");
+            if (d.args.size() == 2)
+                links.insert({d.args[0], d.args[1]});
+        }
+        else if (d.kind == "queue")
+        {
+            if (d.args.size() != 2)
+                errors.push_back(at + "expected queue <a> <b> disc=<type>");
+            else if (!links.count({d.args[0], d.args[1]}))
+                errors.push_back(at + "no earlier link " + d.args[0] + " " + d.args[1]);
+            TypeId tid;
+            if (d.kv.count("disc") &&
+                (!TypeId::LookupByNameFailSafe(d.kv.at("disc"), &tid) ||
+                 !tid.IsChildOf(TypeId::LookupByName("ns3::QueueDisc"))))
+                errors.push_back(at + "not a queue disc: " + d.kv.at("disc"));
+            else if (d.kv.count("disc") && d.kv.count("maxSize") &&
+                     !IsValidConfig(d.kv.at("disc") + "::MaxSize", d.kv.at("maxSize"), why))
+                errors.push_back(at + why);
+        }
+        else if (d.kind == "trace")
+        {
+            if (d.args.size() != 1 || d.args[0] != "cwnd")
+                errors.push_back(at + "expected trace cwnd node=<node> file=<path>");
+            if (d.kv.count("node"))
+                checkNode(d.kv.at("node"));
+            checkSingle("node");
+            checkNumber("start");
+        }
+        else if (d.kind == "bulk" || d.kind == "echo")
+        {
+            for (const char* k : {"from", "to", "server", "clients"})
+                if (d.kv.count(k))
+                    checkNode(d.kv.at(k));
+            checkSingle("from");
+            checkSingle("server");
+            for (const char* k : {"port", "sendSize", "maxBytes", "packets", "size"})
+                checkUnsigned(k);
+            if (d.kv.count("port") && IsUnsigned(d.kv.at("port")) && std::stoul(d.kv.at("port")) > 65535)
+                errors.push_back(at + "port out of range: " + d.kv.at("port"));
+            for (const char* k : {"stop", "sinkStart", "serverStart", "serverStop"})
+                checkNumber(k);
+            if (d.kv.count("interval") && !IsTime(d.kv.at("interval")))
+                errors.push_back(at + "bad interval " + d.kv.at("interval"));
+            if (d.kv.count("start"))
+                for (const auto& s : Split(d.kv.at("start"), ':'))
+                    if (!IsNumber(s))
+                        errors.push_back(at + "bad start " + d.kv.at("start"));
+        }
+    }
+}
+
+// Traces de cwnd (diretiva trace), gravados pela thread do AsyncWriter. Mesmo
+// formato do 1-a: "0.0 <cwnd inicial>" uma vez por arquivo e "<t> <cwnd>".
+static asyncwriter::AsyncWriter g_traceWriter;
+
+static void CwndTracer(uint32_t stream, uint32_t oldval, uint32_t newval)
+{
+    static std::vector<bool> started;
+    if (stream >= started.size())
+        started.resize(stream + 1, false);
+    if (!started[stream])
+    {
+        g_traceWriter.Push(stream, "0.0", oldval);
+        started[stream] = true;
+    }
+    g_traceWriter.Push(stream, Simulator::Now().GetSeconds(), newval);
+}
+
+// Agendado depois do Start das aplicacoes, quando os sockets ja existem.
+static void TraceCwnd(const std::string& file, uint32_t nodeId)
+{
+    uint32_t stream = g_traceWriter.Open(file);
+    Config::ConnectWithoutContext("/NodeList/" + std::to_string(nodeId) +
+                                      "/$ns3::TcpL4Protocol/SocketList/*/CongestionWindow",
+                                  MakeBoundCallback(&CwndTracer, stream));
+}
+
+static int RunScenario(const std::vector<Directive>& directives)
+{
+    for (const auto& d : directives)
+    {
+        if (d.kind == "config")
+            Config::SetDefault(d.kv.begin()->first, StringValue(d.kv.begin()->second));
+        else if (d.kind == "log")
+            LogComponentEnable(d.args[0].c_str(), LOG_LEVEL_INFO);
+    }
+
+    // Nos, na ordem do arquivo; grupos com count viram nome0..nomeN-1.
+    std::map<std::string, NodeContainer> groups;
+    for (const auto& d : directives)
+    {
+        if (d.kind == "node")
+            groups[d.args[0]].Create(std::stoul(Get(d, "count", "1")));
+    }
+
+    // Um modelo de erro por enlace, compartilhado pelos dois devices (como nos
+    // scripts). Os modelos pegam streams de RNG ao nascer, entao a ordem em
+    // relacao a pilha muda os numeros.
+    bool errorModelsFirst = false;
+    for (const auto& d : directives)
+        if (d.kind == "stack")
+            errorModelsFirst = Get(d, "errorModels", "after") == "before";
+
+    InternetStackHelper stack;
+    if (!errorModelsFirst)
+        stack.InstallAll();
+
+    std::vector<const Directive*> links;
+    std::map<const Directive*, Ptr<RateErrorModel>> errorModels;
+    for (const auto& d : directives)
+    {
+        if (d.kind != "link")
+            continue;
+        links.push_back(&d);
+        if (d.kv.count("errorRate"))
+        {
+            Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
+            em->SetAttribute("ErrorRate", DoubleValue(std::stod(d.kv.at("errorRate"))));
+            errorModels[&d] = em;
+        }
+    }
+
+    if (errorModelsFirst)
+        stack.InstallAll();
+
+    std::vector<NetDeviceContainer> devices;
+    std::map<std::pair<std::string, std::string>, NetDeviceContainer> linkDevices;
+    for (const Directive* l : links)
+    {
+        PointToPointHelper p2p;
+        p2p.SetDeviceAttribute("DataRate", StringValue(l->kv.at("rate")));
+        p2p.SetChannelAttribute("Delay", StringValue(l->kv.at("delay")));
+        const NodeContainer& a = groups[l->args[0]];
+        const NodeContainer& b = groups[l->args[1]];
+        for (uint32_t i = 0; i < a.GetN(); ++i)
+        {
+            for (uint32_t j = 0; j < b.GetN(); ++j)
+            {
+                NetDeviceContainer dev = p2p.Install(a.Get(i), b.Get(j));
+                if (errorModels.count(l))
+                    for (uint32_t k = 0; k < dev.GetN(); ++k)
+                        DynamicCast<PointToPointNetDevice>(dev.Get(k))
+                            ->SetReceiveErrorModel(errorModels[l]);
+                devices.push_back(dev);
+                linkDevices[{l->args[0], l->args[1]}].Add(dev);
+            }
+        }
+    }
+
+    // Queue discs antes dos enderecos: o Ipv4AddressHelper so instala o
+    // padrao em devices que ainda nao tem um.
+    for (const auto& d : directives)
+    {
+        if (d.kind != "queue")
+            continue;
+        TrafficControlHelper tch;
+        if (d.kv.count("maxSize"))
+            tch.SetRootQueueDisc(d.kv.at("disc"), "MaxSize", StringValue(d.kv.at("maxSize")));
+        else
+            tch.SetRootQueueDisc(d.kv.at("disc"));
+        tch.Install(linkDevices[{d.args[0], d.args[1]}]);
+    }
+
+    // Endereco de cada no = o do seu primeiro enlace.
+    Ipv4AddressHelper addr;
+    addr.SetBase("10.1.1.0", "255.255.255.0");
+    std::map<uint32_t, Ipv4Address> firstAddr;
+    for (std::size_t k = 0; k < devices.size(); ++k)
+    {
+        if (k > 0)
+            addr.NewNetwork();
+        Ipv4InterfaceContainer ifc = addr.Assign(devices[k]);
+        for (uint32_t i = 0; i < ifc.GetN(); ++i)
+        {
+            uint32_t nodeId = devices[k].Get(i)->GetNode()->GetId();
+            if (!firstAddr.count(nodeId))
+                firstAddr[nodeId] = ifc.GetAddress(i);
+        }
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    struct Flow
+    {
+        Ptr<PacketSink> sink;
+        double active;
+    };
+    std::vector<Flow> flows;
+    bool tracing = false;
+    for (const auto& d : directives)
+    {
+        if (d.kind == "bulk")
+        {
+            const NodeContainer& from = groups[d.kv.at("from")];
+            const NodeContainer& to = groups[d.kv.at("to")];
+            uint16_t port = std::stoul(d.kv.at("port"));
+            double start = std::stod(Get(d, "start", "1"));
+            double stop = std::stod(Get(d, "stop", "20"));
+            for (uint32_t i = 0; i < to.GetN(); ++i)
+            {
+                Address sinkAddr(InetSocketAddress(firstAddr[to.Get(i)->GetId()], port + i));
+                PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", sinkAddr);
+                ApplicationContainer sinkApp = sinkHelper.Install(to.Get(i));
+                sinkApp.Start(Seconds(std::stod(Get(d, "sinkStart", "0"))));
+                sinkApp.Stop(Seconds(stop));
+                flows.push_back({DynamicCast<PacketSink>(sinkApp.Get(0)), stop - start});
+
+                BulkSendHelper sender("ns3::TcpSocketFactory", sinkAddr);
+                sender.SetAttribute("MaxBytes", UintegerValue(std::stoull(Get(d, "maxBytes", "0"))));
+                sender.SetAttribute("SendSize", UintegerValue(std::stoul(Get(d, "sendSize", "512"))));
+                ApplicationContainer srcApp = sender.Install(from.Get(0));
+                srcApp.Start(Seconds(start));
+                srcApp.Stop(Seconds(stop));
+            }
+        }
+        else if (d.kind == "echo")
+        {
+            Ptr<Node> server = groups[d.kv.at("server")].Get(0);
+            const NodeContainer& clients = groups[d.kv.at("clients")];
+            uint16_t port = std::stoul(d.kv.at("port"));
+            double stop = std::stod(Get(d, "stop", "20"));
+
+            UdpEchoServerHelper echoServer(port);
+            ApplicationContainer serverApps = echoServer.Install(server);
+            serverApps.Start(Seconds(std::stod(Get(d, "serverStart", "1"))));
+            serverApps.Stop(Seconds(std::stod(Get(d, "serverStop", Get(d, "stop", "20")))));
+
+            std::vector<std::string> start = Split(Get(d, "start", "2"), ':');
+            for (uint32_t i = 0; i < clients.GetN(); ++i)
+            {
+                UdpEchoClientHelper echoClient(firstAddr[server->GetId()], port);
+                echoClient.SetAttribute("MaxPackets", UintegerValue(std::stoul(Get(d, "packets", "1"))));
+                echoClient.SetAttribute("Interval", TimeValue(Time(Get(d, "interval", "1s"))));
+                echoClient.SetAttribute("PacketSize", UintegerValue(std::stoul(Get(d, "size", "1024"))));
+                ApplicationContainer clientApp = echoClient.Install(clients.Get(i));
+
+                // start=a:b sorteia o inicio em U(a, b), como no first.cc.
+                double t = std::stod(start[0]);
+                if (start.size() > 1)
+                {
+                    Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+                    t = rand->GetValue(std::stod(start[0]), std::stod(start[1]));
+                }
+                clientApp.Start(Seconds(t));
+                clientApp.Stop(Seconds(stop));
+            }
+        }
+        else if (d.kind == "trace")
+        {
+            // Flush garantido: esvazia a fila e fecha os arquivos no Simulator::Destroy().
+            if (!tracing)
+                Simulator::ScheduleDestroy(&asyncwriter::AsyncWriter::Stop, &g_traceWriter);
+            tracing = true;
+            Simulator::Schedule(Seconds(std::stod(Get(d, "start", "1.01"))),
+                                &TraceCwnd,
+                                d.kv.at("file"),
+                                groups[d.kv.at("node")].Get(0)->GetId());
+        }
+        else if (d.kind == "stop")
+        {
+            Simulator::Stop(Seconds(std::stod(d.args[0])));
+        }
+    }
+
+    Simulator::Run();
+
+    double aggGoodput = 0.0;
+    for (uint32_t i = 0; i < flows.size(); ++i)
+    {
+        double g = (flows[i].sink->GetTotalRx() * 8.0) / flows[i].active;
+        aggGoodput += g;
+        std::cout << "Flow " << i << " Goodput=" << g / 1e6 << " Mbps" << std::endl;
+    }
+    if (!flows.empty())
+        std::cout << "Goodput_agregado=" << aggGoodput / 1e6 << " Mbps" << std::endl;
+
+    Simulator::Destroy();
+    if (tracing)
+        g_traceWriter.PrintStats(std::cout);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string file = "";
+    std::string set = "";
+    bool validate = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("file", "Scenario description file", file);
+    cmd.AddValue("set", "Variable overrides: name=value;name2=value2", set);
+    cmd.AddValue("validate", "Only parse and validate the scenario", validate);
+    cmd.Parse(argc, argv);
+
+    Scenario scn;
+    std::vector<std::string> errors;
+    if (file.empty())
+        errors.push_back("--file is required");
+    else
+        ParseScenario(file, scn, errors);
+
+    std::map<std::string, std::string> overrides;
+    for (const auto& item : Split(set, ';'))
+    {
+        std::size_t eq = item.find('=');
+        if (eq == std::string::npos)
+            errors.push_back("bad --set item " + item);
+        else
+            overrides[item.substr(0, eq)] = item.substr(eq + 1);
+    }
+
+    // Pontos da varredura: produto cartesiano dos eixos (um ponto se nao houver).
+    std::vector<std::map<std::string, std::string>> points = {overrides};
+    for (const auto& axis : scn.sweeps)
+    {
+        if (overrides.count(axis.first))
+            continue;
+        std::vector<std::map<std::string, std::string>> next;
+        for (const auto& p : points)
+        {
+            for (const auto& v : axis.second)
+            {
+                std::map<std::string, std::string> q = p;
+                q[axis.first] = v;
+                next.push_back(q);
+            }
+        }
+        points = next;
+    }
+
+    for (const auto& p : points)
+        Validate(Resolve(scn, p, errors), errors);
+
+    if (!errors.empty())
+    {
+        // O mesmo erro se repete em cada ponto da varredura; mostra uma vez.
+        std::set<std::string> seen;
+        for (const auto& e : errors)
+            if (seen.insert(e).second)
+                std::cerr << file << ": " << e << std::endl;
+        return 1;
+    }
+    if (validate)
+    {
+        std::cout << file << ": OK (" << scn.directives.size() << " directives, " << points.size()
+                  << " point(s))" << std::endl;
+        return 0;
+    }
+
+    if (points.size() == 1)
+        return RunScenario(Resolve(scn, points[0], errors));
+
+    // Cada ponto da varredura roda num processo novo, com o simulador limpo.
+    int failures = 0;
+    for (const auto& p : points)
+    {
+        std::cout << "#";
+        for (const auto& axis : scn.sweeps)
+            std::cout << " " << axis.first << "=" << p.at(axis.first);
+        std::cout << std::endl;
+
+        pid_t pid = fork();
+        if (pid == 0)
+            _exit(RunScenario(Resolve(scn, p, errors)));
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != 0)
+            ++failures;
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -9,6 +9,7 @@
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
+#include "sim-stats.h"
 
 using namespace ns3;
 
@@ -21,10 +22,12 @@ int main(int argc, char* argv[])
     bool verbose = true;
     uint32_t nCsma = 4;   
     uint32_t nPackets = 1; 
+    bool simStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("nPackets", "Number of packets per client (max 20)", nPackets);
     cmd.AddValue("verbose", "Tell echo applications to log if true", verbose);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
     cmd.Parse(argc, argv);
 
     if (nPackets > 20) nPackets = 20;
@@ -94,7 +97,7 @@ int main(int argc, char* argv[])
 
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
-    Simulator::Run();
+    RunSimulation(simStats);
     Simulator::Destroy();
     return 0;
 }
@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SIM_STATS_H
+#define SIM_STATS_H
+
+// Simulator::Run() medido: devolve o tempo de parede e, com print = true,
+// imprime "SimStats wall=<s> events=<n> eventsPerSec=<n>", linha lida pelo
+// bench/run-benchmarks.sh.
+
+#include "ns3/simulator.h"
+#include <chrono>
+#include <iostream>
+
+namespace ns3
+{
+
+inline double RunSimulation(bool print)
+{
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (print)
+    {
+        uint64_t events = Simulator::GetEventCount();
+        std::cout << "SimStats wall=" << wall
+                  << " events=" << events
+                  << " eventsPerSec=" << (wall > 0 ? events / wall : 0.0) << std::endl;
+    }
+    return wall;
+}
+
+} // namespace ns3
+
+#endif // SIM_STATS_H
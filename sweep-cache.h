@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SWEEP_CACHE_H
+#define SWEEP_CACHE_H
+
+// Cache de resultados de varredura enderecado por conteudo.
+//
+// A chave e um hash do nome do cenario, do conjunto completo de parametros
+// (linha de comando + valores efetivos do ponto), da semente e do RngRun, das
+// variaveis NS_GLOBAL_VALUE e NS_ATTRIBUTE_DEFAULT (que tambem mudam
+// sementes e defaults sem passar pela linha de comando) e da build: o
+// conteudo do binario em execucao mais caminho, tamanho e mtime de cada
+// libns3-*.so carregada. Recompilar o cenario ou qualquer modulo do ns-3
+// invalida todas as entradas. Cada entrada e um arquivo <dir>/<chave> com o
+// registro de resultado.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <link.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace sweepcache
+{
+
+inline uint64_t Fnv1a(const void* data, std::size_t len, uint64_t h = 0xcbf29ce484222325ULL)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+inline std::string ToHex(uint64_t v)
+{
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+    return buf;
+}
+
+// Os scratch linkam os modulos do ns-3 dinamicamente; hashear o conteudo de
+// todas as .so custaria segundos por execucao, entao entram so os metadados.
+inline int HashNs3Module(struct dl_phdr_info* info, std::size_t, void* data)
+{
+    std::string path = info->dlpi_name ? info->dlpi_name : "";
+    struct stat st;
+    if (path.find("libns3") == std::string::npos || stat(path.c_str(), &st) != 0)
+        return 0;
+    uint64_t& h = *static_cast<uint64_t*>(data);
+    uint64_t meta[3] = {static_cast<uint64_t>(st.st_size),
+                        static_cast<uint64_t>(st.st_mtim.tv_sec),
+                        static_cast<uint64_t>(st.st_mtim.tv_nsec)};
+    h = Fnv1a(path.data(), path.size(), h);
+    h = Fnv1a(meta, sizeof(meta), h);
+    return 0;
+}
+
+// Hash da build atual, calculado uma vez por processo.
+inline const std::string& BuildHash()
+{
+    static const std::string hash = [] {
+        std::ifstream exe("/proc/self/exe", std::ios::binary);
+        uint64_t h = Fnv1a(nullptr, 0);
+        char buf[1 << 16];
+        while (exe.read(buf, sizeof(buf)) || exe.gcount() > 0)
+            h = Fnv1a(buf, exe.gcount(), h);
+        dl_iterate_phdr(&HashNs3Module, &h);
+        return ToHex(h);
+    }();
+    return hash;
+}
+
+inline std::string MakeKey(const std::string& scenario,
+                           const std::vector<std::string>& params,
+                           uint32_t seed,
+                           uint64_t run)
+{
+    std::ostringstream key;
+    key << scenario << '\0' << seed << '\0' << run << '\0' << BuildHash();
+    for (const char* var : {"NS_GLOBAL_VALUE", "NS_ATTRIBUTE_DEFAULT"})
+    {
+        const char* v = std::getenv(var);
+        key << '\0' << var << '=' << (v ? v : "");
+    }
+    for (const auto& p : params)
+        key << '\0' << p;
+    std::string s = key.str();
+    return ToHex(Fnv1a(s.data(), s.size()));
+}
+
+class SweepCache
+{
+  public:
+    explicit SweepCache(std::string dir)
+        : m_dir(std::move(dir))
+    {
+        if (!m_dir.empty())
+            mkdir(m_dir.c_str(), 0755);
+    }
+
+    bool IsEnabled() const { return !m_dir.empty(); }
+
+    bool Lookup(const std::string& key, std::string& record) const
+    {
+        if (!IsEnabled())
+            return false;
+        std::ifstream in(m_dir + "/" + key, std::ios::binary);
+        if (!in)
+            return false;
+        record.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Grava num temporario e renomeia, para nunca deixar entrada parcial.
+    void Store(const std::string& key, const std::string& record) const
+    {
+        if (!IsEnabled())
+            return;
+        std::string path = m_dir + "/" + key;
+        std::string tmp = path + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out << record;
+            if (!out)
+                return;
+        }
+        std::rename(tmp.c_str(), path.c_str());
+    }
+
+  private:
+    std::string m_dir;
+};
+
+} // namespace sweepcache
+
+#endif // SWEEP_CACHE_H
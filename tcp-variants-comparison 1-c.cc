@@ -5,6 +5,10 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
+#include "large-bdp.h"
+#include "rtt-stats.h"
+#include "scenario-results.h"
+#include "sim-stats.h"
 #include <iostream>
 #include <string>
 
@@ -20,7 +24,14 @@ int main(int argc, char* argv[])
     double errorRate = 0.00001;
     uint16_t nFlows = 1;
     std::string prefix = "lab2-part1c";
+    std::string resultsFile = "";
     double sim_stop = 20.0;
+    std::string accessRate = "100Mbps";
+    std::string accessDelay = "0.01ms";
+    bool largeBdp = false;
+    uint32_t mtu = 9000;
+    bool simStats = false;
+    bool rttStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("transport_prot", "TcpCubic or TcpNewReno", transport_prot);
@@ -29,13 +40,26 @@ int main(int argc, char* argv[])
     cmd.AddValue("errorRate", "Bottleneck error rate", errorRate);
     cmd.AddValue("nFlows", "Number of TCP flows", nFlows);
     cmd.AddValue("prefix", "Output prefix", prefix);
+    cmd.AddValue("accessRate", "Access (non-bottleneck) link data rate", accessRate);
+    cmd.AddValue("largeBdp", "Jumbo MTU, MTU-sized segments, BDP-sized TCP buffers, errorRate 0 unless given", largeBdp);
+    cmd.AddValue("mtu", "Device MTU in large-BDP mode (> 52)", mtu);
+    cmd.AddValue("results", "Append per-flow results to this results file", resultsFile);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
+    cmd.AddValue("rttStats", "Print RTT percentiles of the source sockets", rttStats);
     cmd.Parse(argc, argv);
+    if (largeBdp)
+        errorRate = LargeBdpErrorRate(errorRate, argc, argv);
 
     if (transport_prot.find("ns3::") == std::string::npos)
         transport_prot = "ns3::" + transport_prot;
     Config::SetDefault("ns3::TcpL4Protocol::SocketType",
                        TypeIdValue(TypeId::LookupByName(transport_prot)));
 
+    uint32_t sendSize = 400;
+    LargeBdpConfig bdpCfg = {largeBdp, dataRate, accessDelay, mtu};
+    if (largeBdp)
+        sendSize = ConfigureLargeBdp(bdpCfg, delay, accessRate);
+
     NodeContainer src, r1, r2, dst;
     src.Create(1);
     r1.Create(1);
@@ -46,8 +70,8 @@ int main(int argc, char* argv[])
     stack.InstallAll();
 
     PointToPointHelper fast, bottleneck;
-    fast.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
-    fast.SetChannelAttribute("Delay", StringValue("0.01ms"));
+    fast.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    fast.SetChannelAttribute("Delay", StringValue(accessDelay));
     bottleneck.SetDeviceAttribute("DataRate", StringValue(dataRate));
     bottleneck.SetChannelAttribute("Delay", StringValue(delay));
 
@@ -61,8 +85,8 @@ int main(int argc, char* argv[])
 
     std::vector<NetDeviceContainer> devR2DstVec;
     PointToPointHelper fast2;
-    fast2.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
-    fast2.SetChannelAttribute("Delay", StringValue("0.01ms"));
+    fast2.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    fast2.SetChannelAttribute("Delay", StringValue(accessDelay));
     for (uint32_t i = 0; i < nFlows; ++i)
         devR2DstVec.push_back(fast2.Install(r2.Get(0), dst.Get(i)));
 
@@ -90,15 +114,18 @@ int main(int argc, char* argv[])
     
         BulkSendHelper srcHelper("ns3::TcpSocketFactory", sinkAddr);
         srcHelper.SetAttribute("MaxBytes", UintegerValue(0));
-        srcHelper.SetAttribute("SendSize", UintegerValue(400));
+        srcHelper.SetAttribute("SendSize", UintegerValue(sendSize));
         ApplicationContainer srcApp = srcHelper.Install(src.Get(0));
         srcApp.Start(Seconds(1.0));
         srcApp.Stop(Seconds(sim_stop));
     }
 
+    RttStats rtt;
+    if (rttStats)
+        Simulator::Schedule(Seconds(1.01), &RttStats::Connect, &rtt, src.Get(0)->GetId());
 
     Simulator::Stop(Seconds(sim_stop));
-    Simulator::Run();
+    double wall = RunSimulation(simStats);
 
     double aggGoodput = 0.0;
     for (uint32_t i = 0; i < sinks.GetN(); ++i)
@@ -115,6 +142,31 @@ int main(int argc, char* argv[])
               << " nFlows=" << nFlows
               << " errorRate=" << errorRate
               << " Goodput_agregado=" << aggGoodput / 1e6 << " Mbps" << std::endl;
+    if (largeBdp)
+        std::cout << "Wall=" << wall << "s"
+                  << " WallPerSimSec=" << wall / (sim_stop - 1.0) << "s"
+                  << " Events=" << Simulator::GetEventCount() << std::endl;
+    if (rttStats)
+        rtt.Print();
+
+    if (!resultsFile.empty())
+    {
+        results::ResultWriter writer(resultsFile, results::FlowSchema());
+        for (uint32_t i = 0; i < sinks.GetN(); ++i)
+        {
+            Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinks.Get(i));
+            double g = sink ? (sink->GetTotalRx() * 8.0) / (sim_stop - 1.0) : 0.0;
+            writer.AddRow({"tcp-variants-1c",
+                           transport_prot.substr(5),
+                           RngSeedManager::GetSeed(),
+                           RngSeedManager::GetRun(),
+                           nFlows,
+                           i,
+                           Time(delay).GetSeconds() * 1000.0,
+                           errorRate,
+                           g / 1e6});
+        }
+    }
 
     Simulator::Destroy();
     return 0;
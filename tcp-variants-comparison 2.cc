@@ -5,6 +5,9 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
+#include "rtt-stats.h"
+#include "scenario-results.h"
+#include "sim-stats.h"
 #include <iostream>
 #include <string>
 
@@ -21,11 +24,17 @@ int main(int argc, char* argv[])
     std::string delay1 = "10ms"; 
     std::string delay2 = "50ms"; 
     double stopTime = 20.0;
+    std::string resultsFile = "";
+    bool simStats = false;
+    bool rttStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("transport_prot", "TCP variant", transport_prot);
     cmd.AddValue("delay1", "Atraso do destino 1", delay1);
     cmd.AddValue("delay2", "Atraso do destino 2", delay2);
+    cmd.AddValue("results", "Append per-flow results to this results file", resultsFile);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
+    cmd.AddValue("rttStats", "Print RTT percentiles of the source sockets", rttStats);
     cmd.Parse(argc, argv);
 
     if (transport_prot.find("ns3::") == std::string::npos)
@@ -94,8 +103,12 @@ int main(int argc, char* argv[])
     srcApp1.Stop(Seconds(stopTime));
     srcApp2.Stop(Seconds(stopTime));
 
+    RttStats rtt;
+    if (rttStats)
+        Simulator::Schedule(Seconds(1.01), &RttStats::Connect, &rtt, source.Get(0)->GetId());
+
     Simulator::Stop(Seconds(stopTime));
-    Simulator::Run();
+    RunSimulation(simStats);
 
     Ptr<PacketSink> sink1 = DynamicCast<PacketSink>(sinkApp1.Get(0));
     Ptr<PacketSink> sink2 = DynamicCast<PacketSink>(sinkApp2.Get(0));
@@ -109,6 +122,21 @@ int main(int argc, char* argv[])
               << " Goodput1=" << g1 / 1e6 << "Mbps"
               << " Goodput2=" << g2 / 1e6 << "Mbps"
               << std::endl;
+    if (rttStats)
+        rtt.Print();
+
+    if (!resultsFile.empty())
+    {
+        // delay_ms aqui e o atraso de acesso de cada fluxo (Delay1/Delay2).
+        results::ResultWriter writer(resultsFile, results::FlowSchema());
+        std::string prot = transport_prot.substr(5);
+        uint32_t seed = RngSeedManager::GetSeed();
+        uint64_t run = RngSeedManager::GetRun();
+        writer.AddRow({"tcp-variants-2", prot, seed, run, 2, 0,
+                       Time(delay1).GetSeconds() * 1000.0, 0.0, g1 / 1e6});
+        writer.AddRow({"tcp-variants-2", prot, seed, run, 2, 1,
+                       Time(delay2).GetSeconds() * 1000.0, 0.0, g2 / 1e6});
+    }
 
     Simulator::Destroy();
     return 0;
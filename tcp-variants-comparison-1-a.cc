@@ -7,6 +7,10 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
 #include "ns3/tcp-header.h"
+#include "async-writer.h"
+#include "rtt-stats.h"
+#include "scenario-results.h"
+#include "sim-stats.h"
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -15,7 +19,9 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("Lab2Part1");
 
-static std::map<uint32_t, Ptr<OutputStreamWrapper>> cWndStream;
+// Traces gravados pela thread do AsyncWriter, fora do loop de eventos.
+static asyncwriter::AsyncWriter traceWriter;
+static std::map<uint32_t, uint32_t> cWndStream;
 static std::map<uint32_t, bool> firstCwnd;
 
 static uint32_t GetNodeIdFromContext(std::string context)
@@ -30,16 +36,15 @@ static void CwndTracer(std::string context, uint32_t oldval, uint32_t newval)
     uint32_t nodeId = GetNodeIdFromContext(context);
     if (firstCwnd[nodeId])
     {
-        *cWndStream[nodeId]->GetStream() << "0.0 " << oldval << std::endl;
+        traceWriter.Push(cWndStream[nodeId], "0.0", oldval);
         firstCwnd[nodeId] = false;
     }
-    *cWndStream[nodeId]->GetStream() << Simulator::Now().GetSeconds() << " " << newval << std::endl;
+    traceWriter.Push(cWndStream[nodeId], Simulator::Now().GetSeconds(), newval);
 }
 
 static void TraceCwnd(std::string cwnd_tr_file_name, uint32_t nodeId)
 {
-    AsciiTraceHelper ascii;
-    cWndStream[nodeId] = ascii.CreateFileStream(cwnd_tr_file_name);
+    cWndStream[nodeId] = traceWriter.Open(cwnd_tr_file_name);
     Config::Connect("/NodeList/0/$ns3::TcpL4Protocol/SocketList/*/CongestionWindow",
                 MakeCallback(&CwndTracer));
 
@@ -59,6 +64,9 @@ int main(int argc, char *argv[])
     uint32_t mtu_bytes = 400;
     double sim_stop = 20.0;
     bool pcap = false;
+    std::string resultsFile = "";
+    bool simStats = false;
+    bool rttStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("dataRate", "Bottleneck data rate", dataRate);
@@ -68,6 +76,9 @@ int main(int argc, char *argv[])
     cmd.AddValue("transport_prot", "TCP variant: TcpCubic or TcpNewReno", transport_prot);
     cmd.AddValue("prefix_name", "Prefix for output files", prefix_file_name);
     cmd.AddValue("tracing", "Enable tracing", tracing);
+    cmd.AddValue("results", "Append per-flow results to this results file", resultsFile);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
+    cmd.AddValue("rttStats", "Print RTT percentiles of the source sockets", rttStats);
     cmd.Parse(argc, argv);
 
     if (transport_prot.find("ns3::") == std::string::npos)
@@ -136,6 +147,8 @@ int main(int argc, char *argv[])
 
     if (tracing)
     {
+        // Flush garantido: esvazia a fila e fecha os arquivos no Simulator::Destroy().
+        Simulator::ScheduleDestroy(&asyncwriter::AsyncWriter::Stop, &traceWriter);
         uint32_t srcId = nodes.Get(0)->GetId();
         firstCwnd[srcId] = true;
         Simulator::Schedule(Seconds(1.01),
@@ -144,12 +157,17 @@ int main(int argc, char *argv[])
                             srcId);
     }
 
+    RttStats rtt;
+    if (rttStats)
+        Simulator::Schedule(Seconds(1.01), &RttStats::Connect, &rtt, nodes.Get(0)->GetId());
+
     if (pcap)
     {
         p2pBottleneck.EnablePcapAll(prefix_file_name);
     }
 
     Simulator::Stop(Seconds(sim_stop));
+    RunSimulation(simStats);
 
     for (uint32_t i = 0; i < sinkApps.GetN(); ++i)
     {
@@ -163,8 +181,31 @@ int main(int argc, char *argv[])
                       << " bps (" << goodput_bps / 1e6 << " Mbps)" << std::endl;
         }
     }
+    if (rttStats)
+        rtt.Print();
 
+    if (!resultsFile.empty())
+    {
+        results::ResultWriter writer(resultsFile, results::FlowSchema());
+        for (uint32_t i = 0; i < sinkApps.GetN(); ++i)
+        {
+            Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApps.Get(i));
+            double g = sink ? (sink->GetTotalRx() * 8.0) / (sim_stop - 1.0) : 0.0;
+            writer.AddRow({"tcp-variants-1a",
+                           transport_prot.substr(5),
+                           RngSeedManager::GetSeed(),
+                           RngSeedManager::GetRun(),
+                           sinkApps.GetN(),
+                           i,
+                           Time(delay).GetSeconds() * 1000.0,
+                           errorRate,
+                           g / 1e6});
+        }
+    }
 
     Simulator::Destroy();
+
+    if (tracing)
+        traceWriter.PrintStats(std::cout);
     return 0;
 }
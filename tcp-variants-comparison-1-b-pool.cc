@@ -0,0 +1,10 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// tcp-variants-comparison-1-b com o packet-pool.h compilado (alocador global
+// substituido, --packetPool, --allocStats e --memReport disponiveis). O
+// binario normal nao paga o cabecalho por bloco nem a contabilidade.
+
+#define PACKET_POOL
+#include "tcp-variants-comparison-1-b.cc"
@@ -6,14 +6,325 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
+#include "async-writer.h"
+#include "batched-p2p-channel.h"
+#include "large-bdp.h"
+#include "packet-pool.h"
+#include "rtt-stats.h"
+#include "scenario-results.h"
+#include "sim-stats.h"
+#include "sweep-cache.h"
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <cerrno>
+#include <map>
+#include <poll.h>
+#include <sstream>
 #include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("Lab2Part1b");
 
+// Um ponto da varredura: parametros aplicados apos a topologia pronta.
+struct SweepPoint
+{
+    std::string transport_prot;
+    std::string delay;
+    double errorRate;
+};
+
+static std::vector<std::string> SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+// Texto que volta exatamente ao mesmo double (std::to_string arredonda em 6 casas).
+static std::string ExactDouble(double v)
+{
+    std::ostringstream ss;
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    ss << v;
+    return ss.str();
+}
+
+static std::string NormalizeProt(std::string prot)
+{
+    if (prot.find("ns3::") == std::string::npos)
+        prot = "ns3::" + prot;
+    return prot;
+}
+
+static double AggregateGoodput(const ApplicationContainer& sinks, double sim_stop)
+{
+    double totalGoodput = 0.0;
+    for (uint32_t i = 0; i < sinks.GetN(); ++i)
+    {
+        Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinks.Get(i));
+        if (sink)
+        {
+            double g = (sink->GetTotalRx() * 8.0) / (sim_stop - 1.0);
+            totalGoodput += g;
+        }
+    }
+    return totalGoodput;
+}
+
+static std::vector<double> FlowGoodputs(const ApplicationContainer& sinks, double sim_stop)
+{
+    std::vector<double> goodputs;
+    for (uint32_t i = 0; i < sinks.GetN(); ++i)
+    {
+        Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinks.Get(i));
+        goodputs.push_back(sink ? (sink->GetTotalRx() * 8.0) / (sim_stop - 1.0) / 1e6 : 0.0);
+    }
+    return goodputs;
+}
+
+// Uma linha por fluxo no arquivo de resultados (esquema results::FlowSchema).
+static void WriteFlowResults(const std::string& path,
+                             const std::string& prot,
+                             uint16_t nFlows,
+                             const std::string& delay,
+                             double errorRate,
+                             const std::vector<double>& goodputs)
+{
+    results::ResultWriter writer(path, results::FlowSchema());
+    for (uint32_t i = 0; i < goodputs.size(); ++i)
+        writer.AddRow({"tcp-variants-1b",
+                       prot.substr(5),
+                       RngSeedManager::GetSeed(),
+                       RngSeedManager::GetRun(),
+                       nFlows,
+                       i,
+                       Time(delay).GetSeconds() * 1000.0,
+                       errorRate,
+                       goodputs[i]});
+}
+
+// Registro de um ponto da varredura (o que o filho devolve e o cache guarda):
+// a linha CSV e, na linha seguinte, o goodput (Mbps) de cada fluxo.
+static std::string EncodePointRecord(const SweepPoint& pt, uint16_t nFlows, const std::vector<double>& goodputs)
+{
+    double total = 0.0;
+    std::ostringstream flows;
+    flows.precision(std::numeric_limits<double>::max_digits10);
+    for (double g : goodputs)
+    {
+        total += g;
+        flows << " " << g;
+    }
+    std::ostringstream rec;
+    rec << pt.transport_prot.substr(5) << ","
+        << nFlows << ","
+        << Time(pt.delay).GetSeconds() * 1000.0 << ","
+        << pt.errorRate << ","
+        << total << "\n"
+        << "flows" << flows.str() << "\n";
+    return rec.str();
+}
+
+static bool DecodePointRecord(const std::string& rec, std::string& row, std::vector<double>& goodputs)
+{
+    std::size_t eol = rec.find('\n');
+    if (eol == std::string::npos || rec.compare(eol + 1, 5, "flows") != 0)
+        return false;
+    row = rec.substr(0, eol + 1);
+    std::istringstream flows(rec.substr(eol + 6));
+    goodputs.clear();
+    double g;
+    while (flows >> g)
+        goodputs.push_back(g);
+    return true;
+}
+
+// Traces de cwnd por fluxo, gravados pela thread do AsyncWriter fora do loop
+// de eventos. Mesmo formato do 1-a: "0.0 <cwnd inicial>" e "<t> <cwnd>".
+static asyncwriter::AsyncWriter g_traceWriter;
+
+static void CwndTracer(uint32_t stream, uint32_t oldval, uint32_t newval)
+{
+    static std::vector<bool> started;
+    if (stream >= started.size())
+        started.resize(stream + 1, false);
+    if (!started[stream])
+    {
+        g_traceWriter.Push(stream, "0.0", oldval);
+        started[stream] = true;
+    }
+    g_traceWriter.Push(stream, Simulator::Now().GetSeconds(), newval);
+}
+
+// Os sockets do BulkSend nascem no Start (1 s), na ordem dos fluxos.
+static void TraceCwnd(const std::string& prefix, uint32_t srcId, uint16_t nFlows)
+{
+    for (uint32_t i = 0; i < nFlows; ++i)
+    {
+        uint32_t stream = g_traceWriter.Open(prefix + "-flow" + std::to_string(i) + "-cwnd.data");
+        Config::ConnectWithoutContext("/NodeList/" + std::to_string(srcId) +
+                                          "/$ns3::TcpL4Protocol/SocketList/" + std::to_string(i) +
+                                          "/CongestionWindow",
+                                      MakeBoundCallback(&CwndTracer, stream));
+    }
+}
+
+// Relatorio de memoria: bytes vivos (contados pelo packet-pool.h, so no
+// build PACKET_POOL) que cada fase da montagem deixou alocados.
+static std::vector<std::pair<std::string, int64_t>> g_memPhases;
+static int64_t g_memMark = 0;
+
+static void MemPhase(const std::string& name)
+{
+    int64_t live = packetpool::GetStats().liveBytes;
+    if (!name.empty())
+        g_memPhases.push_back({name, live - g_memMark});
+    g_memMark = live;
+}
+
+// Bytes de uma instancia nova do TypeId (delta de liveBytes em torno do
+// ObjectFactory::Create). Nao inclui o estado que os helpers acrescentam
+// depois (rotas, enderecos, sockets); esse fica nos totais por fase.
+static int64_t ProbeTypeBytes(TypeId tid)
+{
+    if (!tid.HasConstructor())
+        return -1;
+    ObjectFactory factory;
+    factory.SetTypeId(tid);
+    int64_t before = packetpool::GetStats().liveBytes;
+    Ptr<Object> obj = factory.Create();
+    return packetpool::GetStats().liveBytes - before;
+}
+
+static void PrintMemReport(uint32_t nNodes, const std::vector<std::pair<std::string, Ptr<Node>>>& roles)
+{
+    int64_t total = 0;
+    std::cout << "MemReport nodes=" << nNodes << std::endl;
+    for (const auto& phase : g_memPhases)
+    {
+        total += phase.second;
+        std::cout << "  " << phase.first << ": " << phase.second << " B ("
+                  << phase.second / nNodes << " B/node)" << std::endl;
+    }
+    std::cout << "  total: " << total << " B (" << total / nNodes << " B/node)" << std::endl;
+
+    // Bytes por TypeId nos nos de amostra: objetos agregados, devices e
+    // aplicacoes. Criar objetos consome streams de RNG e mudaria os
+    // resultados, entao as sondas rodam num filho do fork.
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid != 0)
+    {
+        if (pid > 0)
+            waitpid(pid, nullptr, 0);
+        return;
+    }
+    int64_t nodeBytes = g_memPhases.empty() ? 0 : g_memPhases.front().second / nNodes;
+    std::map<std::string, int64_t> typeBytes;
+    for (const auto& role : roles)
+    {
+        std::map<std::string, std::pair<TypeId, uint32_t>> types;
+        auto add = [&types](TypeId tid) {
+            auto& t = types.insert({tid.GetName(), {tid, 0}}).first->second;
+            ++t.second;
+        };
+        Object::AggregateIterator it = role.second->GetAggregateIterator();
+        while (it.HasNext())
+            add(it.Next()->GetInstanceTypeId());
+        for (uint32_t d = 0; d < role.second->GetNDevices(); ++d)
+            add(role.second->GetDevice(d)->GetInstanceTypeId());
+        for (uint32_t a = 0; a < role.second->GetNApplications(); ++a)
+            add(role.second->GetApplication(a)->GetInstanceTypeId());
+
+        int64_t sum = 0;
+        std::cout << "  node " << role.first << " (bytes per fresh instance):" << std::endl;
+        for (const auto& t : types)
+        {
+            auto known = typeBytes.find(t.first);
+            if (known == typeBytes.end())
+            {
+                // O Node ja esta medido na fase "nodes"; criar outro o registraria na NodeList.
+                int64_t b = t.first == "ns3::Node" ? nodeBytes : ProbeTypeBytes(t.second.first);
+                known = typeBytes.insert({t.first, b}).first;
+            }
+            std::cout << "    " << t.first << " x" << t.second.second << ": ";
+            if (known->second < 0)
+                std::cout << "n/a (no constructor)" << std::endl;
+            else
+            {
+                sum += known->second * t.second.second;
+                std::cout << known->second * t.second.second << " B" << std::endl;
+            }
+        }
+        std::cout << "    sum: " << sum << " B" << std::endl;
+    }
+    std::cout.flush();
+    _exit(0);
+}
+
+// Filho do fork: aplica os parametros do ponto, roda e devolve o registro pelo pipe.
+static void RunSweepChild(const SweepPoint& pt,
+                          Ptr<Channel> bottleneck,
+                          Ptr<RateErrorModel> em,
+                          const ApplicationContainer& sinks,
+                          uint16_t nFlows,
+                          double sim_stop,
+                          const LargeBdpConfig& bdpCfg,
+                          int fd)
+{
+    Config::Set("/NodeList/*/$ns3::TcpL4Protocol/SocketType",
+                TypeIdValue(TypeId::LookupByName(pt.transport_prot)));
+    bottleneck->SetAttribute("Delay", StringValue(pt.delay));
+    em->SetAttribute("ErrorRate", DoubleValue(pt.errorRate));
+    // Os sockets so sao criados no Run(), entao os defaults ainda valem aqui.
+    if (bdpCfg.enabled)
+        ConfigureLargeBdpBuffers(bdpCfg, pt.delay);
+
+    Simulator::Stop(Seconds(sim_stop));
+    Simulator::Run();
+
+    std::string out = EncodePointRecord(pt, nFlows, FlowGoodputs(sinks, sim_stop));
+    ssize_t written = write(fd, out.data(), out.size());
+    _exit(written == static_cast<ssize_t>(out.size()) ? 0 : 1);
+}
+
+// Saida do modo fan-out, na ordem da varredura; os resultados por fluxo vem
+// dos registros, entao pontos servidos pelo cache tambem entram no arquivo.
+static int FinishSweep(const std::vector<SweepPoint>& points,
+                       const std::vector<std::string>& records,
+                       std::size_t nSimulated,
+                       int failures,
+                       uint16_t nFlows,
+                       const std::string& resultsFile)
+{
+    std::cout << "Protocol,nFlows,Delay(ms),ErrorRate,Goodput(Mbps)" << std::endl;
+    for (std::size_t k = 0; k < points.size(); ++k)
+    {
+        std::string row;
+        std::vector<double> goodputs;
+        if (!DecodePointRecord(records[k], row, goodputs))
+            continue;
+        std::cout << row;
+        if (!resultsFile.empty())
+            WriteFlowResults(resultsFile, points[k].transport_prot, nFlows, points[k].delay,
+                             points[k].errorRate, goodputs);
+    }
+    std::cerr << points.size() - nSimulated << " cached, " << nSimulated
+              << " simulated" << std::endl;
+    if (failures > 0)
+        std::cerr << failures << " sweep point(s) failed" << std::endl;
+    return failures > 0 ? 1 : 0;
+}
+
 int main(int argc, char* argv[])
 {
     std::string transport_prot = "TcpCubic";
@@ -22,8 +333,28 @@ int main(int argc, char* argv[])
     double errorRate = 0.00001;
     uint16_t nFlows = 1;
     std::string prefix = "lab2-part1b";
+    std::string resultsFile = "";
     double sim_stop = 20.0;
     uint64_t data_mbytes = 0;
+    std::string accessRate = "100Mbps";
+    std::string accessDelay = "0.01ms";
+    bool largeBdp = false;
+    uint32_t mtu = 9000;
+    bool batchedLinks = false;
+    std::string batchWindow = "";
+    bool packetPool = false;
+    bool allocStats = false;
+    bool slimStack = false;
+    bool memReport = false;
+    std::string sweepProt = "";
+    std::string sweepDelay = "";
+    std::string sweepErrorRate = "";
+    uint32_t jobs = std::thread::hardware_concurrency();
+    std::string cacheDir = "";
+    bool dryRun = false;
+    bool simStats = false;
+    bool cwndTrace = false;
+    bool rttStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("transport_prot", "TcpCubic or TcpNewReno", transport_prot);
@@ -32,42 +363,174 @@ int main(int argc, char* argv[])
     cmd.AddValue("errorRate", "Error rate", errorRate);
     cmd.AddValue("nFlows", "Number of TCP flows", nFlows);
     cmd.AddValue("prefix", "Output prefix", prefix);
+    cmd.AddValue("simStop", "Simulation stop time (s)", sim_stop);
+    cmd.AddValue("accessRate", "Access (non-bottleneck) link data rate", accessRate);
+    cmd.AddValue("largeBdp", "Jumbo MTU, MTU-sized segments, BDP-sized TCP buffers, errorRate 0 unless given", largeBdp);
+    cmd.AddValue("mtu", "Device MTU in large-BDP mode (> 52)", mtu);
+    cmd.AddValue("batchedLinks",
+                 "Let one receive event on access links also deliver packets already in flight behind it",
+                 batchedLinks);
+    cmd.AddValue("batchWindow",
+                 "Max early delivery of a batched packet (default: one segment's access tx time)",
+                 batchWindow);
+    cmd.AddValue("packetPool", "Recycle packet/buffer memory through per-size free lists", packetPool);
+    cmd.AddValue("allocStats", "Print allocation and pool hit/miss counters", allocStats);
+    cmd.AddValue("slimStack", "Install only the IPv4 stack (no IPv6)", slimStack);
+    cmd.AddValue("memReport", "Print memory per setup phase and bytes per TypeId on sample nodes", memReport);
+    cmd.AddValue("results", "Append per-flow results to this results file", resultsFile);
+    cmd.AddValue("sweepProt", "Comma-separated TCP variants to sweep (fork mode)", sweepProt);
+    cmd.AddValue("sweepDelay", "Comma-separated bottleneck delays to sweep (fork mode)", sweepDelay);
+    cmd.AddValue("sweepErrorRate", "Comma-separated error rates to sweep (fork mode)", sweepErrorRate);
+    cmd.AddValue("jobs", "Max concurrent child processes in fork mode", jobs);
+    cmd.AddValue("cacheDir", "Sweep result cache directory (fork mode)", cacheDir);
+    cmd.AddValue("dryRun", "Only report how many sweep points would be recomputed", dryRun);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
+    cmd.AddValue("cwndTrace", "Write <prefix>-flow<i>-cwnd.data through the async trace writer", cwndTrace);
+    cmd.AddValue("rttStats", "Print RTT percentiles of the source sockets (not in sweeps)", rttStats);
     cmd.Parse(argc, argv);
+    if ((packetPool || allocStats) && !packetpool::kEnabled)
+        NS_FATAL_ERROR("packetPool/allocStats need the PACKET_POOL build (tcp-variants-comparison-1-b-pool)");
+    if (memReport && !packetpool::kEnabled)
+        NS_FATAL_ERROR("memReport needs the PACKET_POOL build (tcp-variants-comparison-1-b-pool)");
+    packetpool::Attach(packetPool);
+    if (largeBdp)
+        errorRate = LargeBdpErrorRate(errorRate, argc, argv);
 
-    if (transport_prot.find("ns3::") == std::string::npos)
-        transport_prot = "ns3::" + transport_prot;
+    transport_prot = NormalizeProt(transport_prot);
     Config::SetDefault("ns3::TcpL4Protocol::SocketType",
                        TypeIdValue(TypeId::LookupByName(transport_prot)));
 
+    // Pontos da varredura e consulta ao cache antes de montar qualquer coisa:
+    // dryRun e varreduras ja cacheadas nao pagam a montagem da topologia.
+    bool sweep = !sweepProt.empty() || !sweepDelay.empty() || !sweepErrorRate.empty();
+    std::vector<SweepPoint> points;
+    std::vector<std::string> keys;
+    std::vector<std::string> records;
+    std::vector<std::size_t> pending;
+    sweepcache::SweepCache cache(cacheDir);
+    if (sweep)
+    {
+        std::vector<std::string> prots = SplitList(sweepProt);
+        std::vector<std::string> delays = SplitList(sweepDelay);
+        std::vector<std::string> errors = SplitList(sweepErrorRate);
+        if (prots.empty()) prots.push_back(transport_prot);
+        if (delays.empty()) delays.push_back(delay);
+        if (errors.empty()) errors.push_back(ExactDouble(errorRate));
+
+        for (const auto& p : prots)
+            for (const auto& d : delays)
+                for (const auto& e : errors)
+                    points.push_back({NormalizeProt(p), d, std::stod(e)});
 
+        // Chave do cache: linha de comando (sem as opcoes que so controlam a
+        // varredura nem as que o ponto substitui), valores efetivos e o ponto,
+        // com o atraso em passos de tempo ("50ms" e "0.05s" dao a mesma
+        // chave); semente, RngRun, ambiente e build entram no MakeKey.
+        std::vector<std::string> baseParams = {"dataRate=" + dataRate,
+                                               "nFlows=" + std::to_string(nFlows),
+                                               "sim_stop=" + ExactDouble(sim_stop),
+                                               "data_mbytes=" + std::to_string(data_mbytes)};
+        for (int a = 1; a < argc; ++a)
+        {
+            std::string arg = argv[a];
+            bool control = false;
+            for (const char* opt : {"--sweepProt=", "--sweepDelay=", "--sweepErrorRate=", "--jobs=",
+                                    "--cacheDir=", "--dryRun", "--results=", "--prefix=",
+                                    "--transport_prot=", "--delay=", "--errorRate="})
+                if (arg.rfind(opt, 0) == 0)
+                    control = true;
+            if (!control)
+                baseParams.push_back(arg);
+        }
+
+        keys.resize(points.size());
+        records.resize(points.size());
+        for (std::size_t k = 0; k < points.size(); ++k)
+        {
+            std::vector<std::string> params = baseParams;
+            params.push_back("transport_prot=" + points[k].transport_prot);
+            params.push_back("delay=" + std::to_string(Time(points[k].delay).GetTimeStep()));
+            params.push_back("errorRate=" + ExactDouble(points[k].errorRate));
+            keys[k] = sweepcache::MakeKey("tcp-variants-1b",
+                                          params,
+                                          RngSeedManager::GetSeed(),
+                                          RngSeedManager::GetRun());
+            std::string row;
+            std::vector<double> goodputs;
+            if (!cache.Lookup(keys[k], records[k]) || !DecodePointRecord(records[k], row, goodputs))
+                pending.push_back(k);
+        }
+
+        if (dryRun)
+        {
+            std::cout << pending.size() << " of " << points.size()
+                      << " point(s) would be recomputed" << std::endl;
+            for (std::size_t k : pending)
+                std::cout << "  " << points[k].transport_prot.substr(5) << " delay=" << points[k].delay
+                          << " errorRate=" << points[k].errorRate << std::endl;
+            return 0;
+        }
+        if (pending.empty())
+            return FinishSweep(points, records, 0, 0, nFlows, resultsFile);
+    }
+
+    uint32_t sendSize = 400;
+    LargeBdpConfig bdpCfg = {largeBdp, dataRate, accessDelay, mtu};
+    if (largeBdp)
+        sendSize = ConfigureLargeBdp(bdpCfg, delay, accessRate);
+
+    MemPhase("");
     NodeContainer src, router1, router2, dst;
     src.Create(1);
     router1.Create(1);
     router2.Create(1);
     dst.Create(nFlows);
+    MemPhase("nodes");
 
+    // Modo enxuto: os cenarios so usam IPv4, entao nao instala IPv6/ICMPv6/NDP.
     InternetStackHelper stack;
+    if (slimStack)
+        stack.SetIpv6StackInstall(false);
     stack.InstallAll();
+    MemPhase("internet stack");
 
     PointToPointHelper p2pSrcR1, p2pR1R2, p2pR2Dst;
-    p2pSrcR1.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
-    p2pSrcR1.SetChannelAttribute("Delay", StringValue("0.01ms"));
+    p2pSrcR1.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    p2pSrcR1.SetChannelAttribute("Delay", StringValue(accessDelay));
     p2pR1R2.SetDeviceAttribute("DataRate", StringValue(dataRate));
     p2pR1R2.SetChannelAttribute("Delay", StringValue(delay));
-    p2pR2Dst.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
-    p2pR2Dst.SetChannelAttribute("Delay", StringValue("0.01ms"));
+    p2pR2Dst.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    p2pR2Dst.SetChannelAttribute("Delay", StringValue(accessDelay));
 
     Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
     em->SetAttribute("ErrorRate", DoubleValue(errorRate));
 
-    NetDeviceContainer devSrcR1 = p2pSrcR1.Install(src.Get(0), router1.Get(0));
+    // Enlaces de acesso em lotes: so os rapidos, o gargalo continua exato. A
+    // janela padrao e o tempo de transmissao de um segmento cheio no acesso
+    // (payload + TCP/timestamps + IPv4 + PPP): na pratica so o enlace da fonte
+    // agrupa, pares de pacotes de uma rajada dividem um evento de recepcao e o
+    // segundo chega no maximo um segmento adiantado (ver batched-p2p-channel.h).
+    Time window = batchWindow.empty() ? DataRate(accessRate).CalculateBytesTxTime(sendSize + 54)
+                                      : Time(batchWindow);
+    std::vector<Ptr<BatchedPointToPointChannel>> batchedChannels;
+    auto installAccess = [&](PointToPointHelper& helper, Ptr<Node> a, Ptr<Node> b) {
+        if (!batchedLinks)
+            return helper.Install(a, b);
+        NetDeviceContainer devs = InstallBatchedPointToPoint(a, b, accessRate, accessDelay, window);
+        batchedChannels.push_back(DynamicCast<BatchedPointToPointChannel>(devs.Get(0)->GetChannel()));
+        return devs;
+    };
+
+    NetDeviceContainer devSrcR1 = installAccess(p2pSrcR1, src.Get(0), router1.Get(0));
     NetDeviceContainer devR1R2 = p2pR1R2.Install(router1.Get(0), router2.Get(0));
     for (uint32_t d = 0; d < devR1R2.GetN(); ++d)
         DynamicCast<PointToPointNetDevice>(devR1R2.Get(d))->SetReceiveErrorModel(em);
 
     std::vector<NetDeviceContainer> devR2DstVec;
     for (uint32_t i = 0; i < nFlows; ++i)
-        devR2DstVec.push_back(p2pR2Dst.Install(router2.Get(0), dst.Get(i)));
+        devR2DstVec.push_back(installAccess(p2pR2Dst, router2.Get(0), dst.Get(i)));
+
+    MemPhase("links");
 
     Ipv4AddressHelper addr;
     addr.SetBase("10.1.1.0", "255.255.255.0");
@@ -81,7 +544,9 @@ int main(int argc, char* argv[])
         addr.NewNetwork();
         ifR2DstVec.push_back(addr.Assign(devR2DstVec[i]));
     }
+    MemPhase("ipv4 interfaces");
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    MemPhase("routing");
 
     uint16_t port = 50000;
     ApplicationContainer sinks;
@@ -97,31 +562,169 @@ int main(int argc, char* argv[])
 
         BulkSendHelper sender("ns3::TcpSocketFactory", sinkAddr);
         sender.SetAttribute("MaxBytes", UintegerValue(data_mbytes));
-        sender.SetAttribute("SendSize", UintegerValue(400));
+        sender.SetAttribute("SendSize", UintegerValue(sendSize));
         ApplicationContainer srcApp = sender.Install(src.Get(0));
         srcApp.Start(Seconds(1.0));
         srcApp.Stop(Seconds(sim_stop));
         sources.Add(srcApp);
     }
 
-    Simulator::Stop(Seconds(sim_stop));
-    Simulator::Run();
+    MemPhase("applications");
+    if (memReport)
+        PrintMemReport(NodeList::GetNNodes(),
+                       {{"src", src.Get(0)}, {"router", router1.Get(0)}, {"dst0", dst.Get(0)}});
 
-    double totalGoodput = 0.0;
-    for (uint32_t i = 0; i < sinks.GetN(); ++i)
+    // Modo fan-out: topologia, pilha e rotas montadas uma vez; cada ponto roda
+    // num filho do fork (copy-on-write) e devolve o resultado por um pipe.
+    if (sweep)
     {
-        Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinks.Get(i));
-        if (sink)
+        if (jobs == 0) jobs = 1;
+        Ptr<Channel> bottleneck = devR1R2.Get(0)->GetChannel();
+        std::map<pid_t, std::pair<std::size_t, int>> children;
+        int failures = 0;
+
+        // Colhe um filho. Os pipes de todos os filhos sao lidos (poll) antes de
+        // qualquer espera: com muitos fluxos o registro passa do buffer do
+        // pipe (64 KiB) e o filho so termina depois que o pai esvazia o pipe.
+        // O filho cujo pipe chega ao EOF e esperado com waitpid() e, se terminou
+        // bem, o registro vai para o cache.
+        auto reap = [&]() {
+            while (!children.empty())
+            {
+                std::vector<pollfd> fds;
+                std::vector<pid_t> pids;
+                for (const auto& c : children)
+                {
+                    fds.push_back({c.second.second, POLLIN, 0});
+                    pids.push_back(c.first);
+                }
+                if (poll(fds.data(), fds.size(), -1) < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    std::cerr << "poll() failed" << std::endl;
+                    return false;
+                }
+                for (std::size_t i = 0; i < fds.size(); ++i)
+                {
+                    if (fds[i].revents == 0)
+                        continue;
+                    std::size_t k = children[pids[i]].first;
+                    char buf[4096];
+                    ssize_t n = read(fds[i].fd, buf, sizeof(buf));
+                    if (n > 0)
+                    {
+                        records[k].append(buf, n);
+                        continue;
+                    }
+                    if (n < 0 && errno == EINTR)
+                        continue;
+
+                    close(fds[i].fd);
+                    children.erase(pids[i]);
+                    int status = 0;
+                    if (waitpid(pids[i], &status, 0) == pids[i] && WIFEXITED(status) &&
+                        WEXITSTATUS(status) == 0)
+                        cache.Store(keys[k], records[k]);
+                    else
+                    {
+                        records[k].clear();
+                        ++failures;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        std::cout.flush();
+        for (std::size_t k : pending)
         {
-            double g = (sink->GetTotalRx() * 8.0) / (sim_stop - 1.0);
-            totalGoodput += g;
+            if (children.size() >= jobs)
+                reap();
+            int fd[2];
+            if (pipe(fd) != 0)
+            {
+                std::cerr << "pipe() failed" << std::endl;
+                return 1;
+            }
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                std::cerr << "fork() failed" << std::endl;
+                return 1;
+            }
+            if (pid == 0)
+            {
+                close(fd[0]);
+                RunSweepChild(points[k], bottleneck, em, sinks, nFlows, sim_stop, bdpCfg, fd[1]);
+            }
+            close(fd[1]);
+            records[k].clear();
+            children[pid] = {k, fd[0]};
         }
+        while (!children.empty() && reap())
+            ;
+
+        Simulator::Destroy();
+        return FinishSweep(points, records, pending.size(), failures, nFlows, resultsFile);
+    }
+
+    if (cwndTrace)
+    {
+        // Flush garantido: esvazia a fila e fecha os arquivos no Simulator::Destroy().
+        Simulator::ScheduleDestroy(&asyncwriter::AsyncWriter::Stop, &g_traceWriter);
+        Simulator::Schedule(Seconds(1.01), &TraceCwnd, prefix, src.Get(0)->GetId(), nFlows);
     }
+    RttStats rtt;
+    if (rttStats)
+        Simulator::Schedule(Seconds(1.01), &RttStats::Connect, &rtt, src.Get(0)->GetId());
+
+    Simulator::Stop(Seconds(sim_stop));
+    double wall = RunSimulation(simStats);
+
+    double totalGoodput = AggregateGoodput(sinks, sim_stop);
     std::cout << "Protocol=" << transport_prot
               << " nFlows=" << nFlows
               << " delay=" << delay
               << " Goodput_agregado=" << totalGoodput / 1e6 << " Mbps" << std::endl;
+    if (largeBdp)
+        std::cout << "Wall=" << wall << "s"
+                  << " WallPerSimSec=" << wall / (sim_stop - 1.0) << "s"
+                  << " Events=" << Simulator::GetEventCount() << std::endl;
+    if (rttStats)
+        rtt.Print();
+    if (batchedLinks)
+    {
+        uint64_t packets = 0;
+        uint64_t events = 0;
+        for (const auto& ch : batchedChannels)
+        {
+            packets += ch->GetNPackets();
+            events += ch->GetNEvents();
+        }
+        // batchedChannels[0] e o enlace da fonte, o unico onde ha rajadas.
+        std::cout << "BatchedLinks window=" << window.GetMicroSeconds() << "us"
+                  << " packets=" << packets
+                  << " rxEvents=" << events
+                  << " srcPackets=" << batchedChannels[0]->GetNPackets()
+                  << " srcRxEvents=" << batchedChannels[0]->GetNEvents() << std::endl;
+    }
+    if (allocStats)
+    {
+        const packetpool::Stats& ps = packetpool::GetStats();
+        std::cout << "Alloc allocs=" << ps.allocs
+                  << " poolHits=" << ps.hits
+                  << " heapCalls=" << ps.misses
+                  << " poolReleases=" << ps.releases << std::endl;
+    }
+
+    if (!resultsFile.empty())
+        WriteFlowResults(resultsFile, transport_prot, nFlows, delay, errorRate, FlowGoodputs(sinks, sim_stop));
 
     Simulator::Destroy();
+
+    if (cwndTrace)
+        g_traceWriter.PrintStats(std::cout);
     return 0;
 }
@@ -8,6 +8,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/ssid.h"
 #include "ns3/yans-wifi-helper.h"
+#include "sim-stats.h"
 
 using namespace ns3;
 
@@ -19,12 +20,14 @@ int main(int argc, char* argv[])
     uint32_t nWifi = 4;
     uint32_t nPackets = 1;
     bool tracing = false;
+    bool simStats = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("nWifi", "Number of wifi STA devices per network", nWifi);
     cmd.AddValue("nPackets", "Number of packets to send (max 20)", nPackets);
     cmd.AddValue("verbose", "Tell echo applications to log if true", verbose);
     cmd.AddValue("tracing", "Enable pcap tracing", tracing);
+    cmd.AddValue("simStats", "Print wall time and event count of Simulator::Run()", simStats);
     cmd.Parse(argc, argv);
 
     if (nWifi > 9)
@@ -157,7 +160,7 @@ int main(int argc, char* argv[])
         phy2.EnablePcap("lab1-part3-network2", apDevices2.Get(0));
     }
 
-    Simulator::Run();
+    RunSimulation(simStats);
     Simulator::Destroy();
     return 0;
 }